@@ -2,7 +2,9 @@
 #define COMMON_HPP
 
 #include <cassert>
+#include <cstddef>
 #include <random>
+#include <vector>
 
 namespace common {
     inline static std::random_device rd;
@@ -13,6 +15,15 @@ namespace common {
         return std::uniform_int_distribution<int> (low, high)(gen);
         // return (::rand()) % (high ) + low;
     }
+    /// graph G (a gr::CSRGraph) on n vertices with m random arcs weighing [0, max_weight]
+    template <typename G>
+    inline G get_random_graph(std::size_t n, std::size_t m, int max_weight = 1) {
+        std::vector<typename G::edge_tuple_t> arcs(m);
+        for(auto& arc : arcs) {
+            arc = { get_random_in_range(0, n - 1), get_random_in_range(0, n - 1), get_random_in_range(0, max_weight) };
+        }
+        return G::from_edges(n, arcs);
+    }
 }
 
 #endif
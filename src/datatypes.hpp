@@ -2,8 +2,11 @@
 #define DATATYPES_HPP
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -12,6 +15,7 @@
 #include <optional>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -141,8 +145,8 @@ namespace dt {
             }
             return std::make_tuple(ret.key, ret.value);
         }
-        inline T& top() const {
-            return m_data[0];
+        inline std::tuple<Key, T> top() const {
+            return std::make_tuple(m_data[0].key, m_data[0].value);
         }
         inline bool delete_element(T* elem) {
             std::size_t i = 0;
@@ -260,6 +264,244 @@ namespace dt {
     template <typename Key, typename T>
     using MaxHeap = Heap<Key, T, a_more_b_fn<Key>>;
 
+    /// min heap over the indices [0, capacity) that tracks where every index
+    /// sits, so decrease-key and erase are O(log n) instead of a linear search.
+    /// D is the number of children per cell, a wider heap is shallower
+    template <typename Key, std::size_t D = 4>
+    class IndexedHeap {
+        static_assert(D >= 2, "a heap needs at least two children per cell");
+    public:
+        inline static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+    private:
+        struct Cell {
+            Key key;
+            std::size_t index;
+        };
+        std::vector<Cell> m_data{};
+        /// position of every index in m_data, NPOS when not in the heap
+        std::vector<std::size_t> m_pos{};
+
+        inline void place(std::size_t at, Cell cell) {
+            m_data[at] = cell;
+            m_pos[cell.index] = at;
+        }
+        inline void sift_up(std::size_t i) {
+            auto cell = m_data[i];
+            while(i > 0) {
+                auto p = (i - 1) / D;
+                if(!(cell.key < m_data[p].key)) break;
+                place(i, m_data[p]);
+                i = p;
+            }
+            place(i, cell);
+        }
+        inline void sift_down(std::size_t i) {
+            auto cell = m_data[i];
+            for(;;) {
+                auto first = i * D + 1;
+                if(first >= m_data.size()) break;
+                auto last = std::min(first + D, m_data.size());
+                auto best = first;
+                for(auto c = first + 1; c < last; c++) {
+                    if(m_data[c].key < m_data[best].key) best = c;
+                }
+                if(!(m_data[best].key < cell.key)) break;
+                place(i, m_data[best]);
+                i = best;
+            }
+            place(i, cell);
+        }
+    public:
+        IndexedHeap() {}
+        explicit IndexedHeap(std::size_t capacity) : m_pos(capacity, NPOS) {}
+
+        inline std::size_t capacity() const {
+            return m_pos.size();
+        }
+        /// growing keeps the current contents
+        inline void resize(std::size_t capacity) {
+            if(capacity > m_pos.size()) m_pos.resize(capacity, NPOS);
+        }
+        inline bool empty() const {
+            return m_data.empty();
+        }
+        inline std::size_t size() const {
+            return m_data.size();
+        }
+        inline bool contains(std::size_t index) const {
+            return m_pos[index] != NPOS;
+        }
+        inline const Key& key(std::size_t index) const {
+            return m_data[m_pos[index]].key;
+        }
+        inline std::tuple<Key, std::size_t> top() const {
+            return { m_data[0].key, m_data[0].index };
+        }
+        inline void push(std::size_t index, Key key) {
+            assert(!contains(index) && "index already in the heap");
+            m_data.push_back({ key, index });
+            sift_up(m_data.size() - 1);
+        }
+        inline void decrease(std::size_t index, Key key) {
+            assert(contains(index) && !(this->key(index) < key) && "decrease-key with a larger key");
+            auto i = m_pos[index];
+            m_data[i].key = key;
+            sift_up(i);
+        }
+        /// inserts index or lowers its key, true if the heap changed
+        inline bool push_or_decrease(std::size_t index, Key key) {
+            if(!contains(index)) {
+                push(index, key);
+                return true;
+            }
+            if(key < this->key(index)) {
+                decrease(index, key);
+                return true;
+            }
+            return false;
+        }
+        inline std::tuple<Key, std::size_t> extract() {
+            auto ret = m_data[0];
+            m_pos[ret.index] = NPOS;
+            auto last = m_data.back();
+            m_data.pop_back();
+            if(!m_data.empty()) {
+                m_data[0] = last;
+                sift_down(0);
+            }
+            return { ret.key, ret.index };
+        }
+        inline void erase(std::size_t index) {
+            auto i = m_pos[index];
+            if(i == NPOS) return;
+            m_pos[index] = NPOS;
+            auto last = m_data.back();
+            m_data.pop_back();
+            if(i == m_data.size()) return;
+            m_data[i] = last;
+            m_pos[last.index] = i;
+            sift_up(i);
+            sift_down(m_pos[last.index]);
+        }
+        /// O(size), not O(capacity)
+        inline void clear() {
+            for(auto& cell : m_data) m_pos[cell.index] = NPOS;
+            m_data.clear();
+        }
+    };
+
+    /// Dial's bucket queue for integer keys where every pushed key is within
+    /// max_step of the last extracted one (shortest paths with weights <= max_step).
+    /// Keys must be pushed in monotone order. An index pushed again with a lower
+    /// key leaves its old copy behind, the caller has to skip stale extractions
+    template <typename Key>
+    class DialQueue {
+        static_assert(std::is_integral_v<Key>, "DialQueue needs integral keys");
+        std::vector<std::vector<std::size_t>> m_buckets{};
+        Key m_current{};
+        std::size_t m_size{};
+    public:
+        /// max_step is the heaviest key step ever pushed, there is no default
+        /// because a window too small for the keys silently wraps around
+        explicit DialQueue(Key max_step) : m_buckets(static_cast<std::size_t>(max_step) + 1) {}
+
+        inline bool empty() const {
+            return m_size == 0;
+        }
+        /// counts stale copies too
+        inline std::size_t size() const {
+            return m_size;
+        }
+        /// kept for interface parity with IndexedHeap, buckets do not depend on the index range
+        inline void resize(std::size_t) {}
+        inline void push(std::size_t index, Key key) {
+            assert(key >= m_current && static_cast<std::size_t>(key - m_current) < m_buckets.size() && "key outside the bucket window");
+            m_buckets[static_cast<std::size_t>(key) % m_buckets.size()].push_back(index);
+            m_size++;
+        }
+        inline bool push_or_decrease(std::size_t index, Key key) {
+            push(index, key);
+            return true;
+        }
+        inline std::tuple<Key, std::size_t> extract() {
+            auto* bucket = &m_buckets[static_cast<std::size_t>(m_current) % m_buckets.size()];
+            while(bucket->empty()) {
+                m_current++;
+                bucket = &m_buckets[static_cast<std::size_t>(m_current) % m_buckets.size()];
+            }
+            auto index = bucket->back();
+            bucket->pop_back();
+            m_size--;
+            return { m_current, index };
+        }
+        inline void clear() {
+            for(auto& bucket : m_buckets) bucket.clear();
+            m_current = 0;
+            m_size = 0;
+        }
+    };
+
+    /// radix heap for non-negative integer keys, monotone like DialQueue but
+    /// without a bound on the key step. Bucket i holds the keys whose highest
+    /// bit differing from the last extracted key is bit i - 1, so every key
+    /// moves down at most once per bit. Stale copies behave as in DialQueue
+    template <typename Key>
+    class RadixHeap {
+        static_assert(std::is_integral_v<Key>, "RadixHeap needs integral keys");
+        using ukey_t = std::make_unsigned_t<Key>;
+        inline static constexpr std::size_t BUCKETS = sizeof(Key) * 8 + 1;
+
+        std::array<std::vector<std::tuple<Key, std::size_t>>, BUCKETS> m_buckets{};
+        Key m_last{};
+        std::size_t m_size{};
+
+        inline std::size_t bucket_of(Key key) const {
+            return std::bit_width(static_cast<ukey_t>(key) ^ static_cast<ukey_t>(m_last));
+        }
+    public:
+        RadixHeap() {}
+
+        inline bool empty() const {
+            return m_size == 0;
+        }
+        /// counts stale copies too
+        inline std::size_t size() const {
+            return m_size;
+        }
+        /// kept for interface parity with IndexedHeap, buckets do not depend on the index range
+        inline void resize(std::size_t) {}
+        inline void push(std::size_t index, Key key) {
+            assert(key >= m_last && "radix heap keys must not go below the last extracted one");
+            m_buckets[bucket_of(key)].emplace_back(key, index);
+            m_size++;
+        }
+        inline bool push_or_decrease(std::size_t index, Key key) {
+            push(index, key);
+            return true;
+        }
+        inline std::tuple<Key, std::size_t> extract() {
+            if(m_buckets[0].empty()) {
+                std::size_t i = 1;
+                while(m_buckets[i].empty()) i++;
+                auto& bucket = m_buckets[i];
+                m_last = std::get<0>(*std::min_element(bucket.begin(), bucket.end()));
+                for(auto& item : bucket) {
+                    m_buckets[bucket_of(std::get<0>(item))].push_back(item);
+                }
+                bucket.clear();
+            }
+            auto ret = m_buckets[0].back();
+            m_buckets[0].pop_back();
+            m_size--;
+            return ret;
+        }
+        inline void clear() {
+            for(auto& bucket : m_buckets) bucket.clear();
+            m_last = 0;
+            m_size = 0;
+        }
+    };
+
     template <typename K, typename T>
     class RBTree {
     private:
@@ -1154,75 +1396,290 @@ namespace dt {
         }
     };
 
-    template<typename T>
-    class UnionFind {
-        struct Node {
-            size_t parent{};
-            size_t size{1};
-            T content{};
-        };
+    /// fixed size bit array packed into 64 bit words
+    class Bitset {
+    public:
+        using word_t = std::uint64_t;
+        inline static constexpr std::size_t bits_in_word = sizeof(word_t) * 8;
+    private:
+        std::vector<word_t> m_words{};
+        std::size_t m_bits{};
+    public:
+        Bitset() {}
+        explicit Bitset(std::size_t bits) : m_words((bits + bits_in_word - 1) / bits_in_word), m_bits(bits) {}
 
-        Node* m_data = nullptr;
-        size_t m_size{0};
+        inline std::size_t size() const {
+            return m_bits;
+        }
+        inline bool test(std::size_t i) const {
+            return (m_words[i / bits_in_word] >> (i % bits_in_word)) & 1;
+        }
+        inline void set(std::size_t i) {
+            m_words[i / bits_in_word] |= word_t{1} << (i % bits_in_word);
+        }
+        inline void reset(std::size_t i) {
+            m_words[i / bits_in_word] &= ~(word_t{1} << (i % bits_in_word));
+        }
+        inline void clear() {
+            std::fill(m_words.begin(), m_words.end(), 0);
+        }
+        inline std::size_t count() const {
+            std::size_t n = 0;
+            for(auto w : m_words) n += std::popcount(w);
+            return n;
+        }
+        /// this |= other, returns true if any bit changed
+        inline bool merge(const Bitset& other) {
+            word_t changed = 0;
+            for(std::size_t i = 0; i < m_words.size(); i++) {
+                changed |= other.m_words[i] & ~m_words[i];
+                m_words[i] |= other.m_words[i];
+            }
+            return changed != 0;
+        }
+        inline word_t* words() {
+            return m_words.data();
+        }
+        inline const word_t* words() const {
+            return m_words.data();
+        }
+        inline std::size_t word_count() const {
+            return m_words.size();
+        }
+    };
+
+    /// set of the indices [0, size), clear() only bumps an epoch counter so it is O(1)
+    class EpochSet {
+        std::vector<std::uint32_t> m_stamps{};
+        std::uint32_t m_epoch{1};
     public:
-        inline UnionFind(const std::vector<T>& v): UnionFind(v.data(), v.size()) {}
-        inline UnionFind(const T* arr, size_t sz){
-            static_assert(std::is_copy_assignable_v<T>, "T must be copy assignable");
-            m_size = sz;
-            m_data = new Node[m_size];
-            for(size_t i = 0; i < m_size; i++){
-                m_data[i] = Node {
-                    .parent = i,
-                    .content = arr[i],
-                };
+        EpochSet() {}
+        explicit EpochSet(std::size_t size) : m_stamps(size, 0) {}
+
+        inline std::size_t size() const {
+            return m_stamps.size();
+        }
+        /// new indices start out of the set
+        inline void resize(std::size_t size) {
+            m_stamps.resize(size, 0);
+        }
+        inline bool contains(std::size_t i) const {
+            return m_stamps[i] == m_epoch;
+        }
+        inline void insert(std::size_t i) {
+            m_stamps[i] = m_epoch;
+        }
+        /// true if i was not in the set before
+        inline bool try_insert(std::size_t i) {
+            if(m_stamps[i] == m_epoch) return false;
+            m_stamps[i] = m_epoch;
+            return true;
+        }
+        inline void erase(std::size_t i) {
+            m_stamps[i] = m_epoch - 1;
+        }
+        inline void clear() {
+            // on wrap around old stamps could match again, wipe them once
+            if(++m_epoch == 0) {
+                std::fill(m_stamps.begin(), m_stamps.end(), 0);
+                m_epoch = 1;
             }
         }
-        inline ~UnionFind(){
-            delete[] m_data;
-            m_size = 0;
+    };
+
+    /// disjoint sets over the dense handles [0, size). Union by size and
+    /// path halving keep find at amortized O(alpha(n))
+    class DisjointSets {
+        std::vector<std::size_t> m_parent{};
+        std::vector<std::size_t> m_size{};
+        std::size_t m_count{};
+    public:
+        DisjointSets() {}
+        explicit DisjointSets(std::size_t size) {
+            reset(size);
         }
 
-        inline T* find(const T& elem){
-            if(auto idx = find_impl(elem); idx < m_size) {
-                return &m_data[idx].content;
-            } else {
-                return nullptr;
+        /// every handle back in a set of its own
+        inline void reset(std::size_t size) {
+            m_parent.resize(size);
+            m_size.assign(size, 1);
+            for(std::size_t i = 0; i < size; i++) {
+                m_parent[i] = i;
             }
+            m_count = size;
         }
-        inline void unionize(const T& x, const T& y){
-            size_t x_idx = find_impl(x);
-            size_t y_idx = find_impl(y);
-            if(x_idx >= m_size || y_idx >= m_size) return;
-            if(m_data[x_idx].size >= m_data[y_idx].size) {
-                m_data[y_idx].parent = x_idx;
-                m_data[x_idx].size += m_data[y_idx].size;
-            } else {
-                m_data[x_idx].parent = y_idx;
-                m_data[y_idx].size += m_data[x_idx].size;
+        /// representative of the set holding x
+        inline std::size_t find(std::size_t x) {
+            while(m_parent[x] != x) {
+                m_parent[x] = m_parent[m_parent[x]];
+                x = m_parent[x];
             }
+            return x;
+        }
+        /// false when x and y already were in the same set
+        inline bool unite(std::size_t x, std::size_t y) {
+            x = find(x);
+            y = find(y);
+            if(x == y) return false;
+            if(m_size[x] < m_size[y]) std::swap(x, y);
+            m_parent[y] = x;
+            m_size[x] += m_size[y];
+            m_count--;
+            return true;
         }
-        inline size_t size() const {
-            return m_size;
+        inline bool same_set(std::size_t x, std::size_t y) {
+            return find(x) == find(y);
         }
-    private:
-        inline size_t find_impl(const T& elem){
-            size_t idx = m_size;
-            for(size_t i = 0; i < m_size; i++){
-                if(m_data[i].content == elem) {
-                    idx = i;
-                    break;
-                }
+        /// elements in the set holding x
+        inline std::size_t set_size(std::size_t x) {
+            return m_size[find(x)];
+        }
+        /// number of disjoint sets
+        inline std::size_t count() const {
+            return m_count;
+        }
+        inline std::size_t size() const {
+            return m_parent.size();
+        }
+    };
+
+    /// DisjointSets that many threads may find and unite on at once. Roots are
+    /// linked with a CAS in a fixed pseudo random priority order (randomized
+    /// linking by index), finds halve the path with single CAS attempts and
+    /// never retry, so a find is wait-free. Only count() is kept, set sizes
+    /// cannot be maintained without locking
+    class ConcurrentDisjointSets {
+        std::vector<std::atomic<std::size_t>> m_parent{};
+        std::atomic<std::size_t> m_count{};
+
+        /// x is linked below y when x has the lower priority
+        inline static bool lower_priority(std::size_t x, std::size_t y) {
+            auto mix = [](std::size_t v) {
+                std::uint64_t z = v + 0x9e3779b97f4a7c15ull;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                return z ^ (z >> 31);
+            };
+            auto a = mix(x), b = mix(y);
+            return a < b || (a == b && x < y);
+        }
+    public:
+        ConcurrentDisjointSets() {}
+        explicit ConcurrentDisjointSets(std::size_t size) {
+            reset(size);
+        }
+
+        /// every handle back in a set of its own, not thread safe
+        inline void reset(std::size_t size) {
+            m_parent = std::vector<std::atomic<std::size_t>>(size);
+            for(std::size_t i = 0; i < size; i++) {
+                m_parent[i].store(i, std::memory_order_relaxed);
+            }
+            m_count.store(size, std::memory_order_relaxed);
+        }
+        /// representative of the set holding x at some point during the call
+        inline std::size_t find(std::size_t x) {
+            while(true) {
+                auto p = m_parent[x].load(std::memory_order_acquire);
+                if(p == x) return x;
+                auto gp = m_parent[p].load(std::memory_order_acquire);
+                if(p == gp) return p;
+                // parents only ever move towards the root, a lost race is fine
+                m_parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel, std::memory_order_relaxed);
+                x = gp;
             }
-            if(idx < m_size){
-                while(m_data[idx].parent != idx){
-                    idx = m_data[idx].parent;
+        }
+        /// false when x and y already were in the same set
+        inline bool unite(std::size_t x, std::size_t y) {
+            while(true) {
+                x = find(x);
+                y = find(y);
+                if(x == y) return false;
+                if(lower_priority(y, x)) std::swap(x, y);
+                auto expected = x;
+                if(m_parent[x].compare_exchange_strong(expected, y, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    m_count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
                 }
-                return idx;
+                // x stopped being a root, start over from its new root
             }
-            return m_size;
+        }
+        /// a false answer holds for the moment x was checked to still be a root
+        inline bool same_set(std::size_t x, std::size_t y) {
+            while(true) {
+                x = find(x);
+                y = find(y);
+                if(x == y) return true;
+                if(m_parent[x].load(std::memory_order_acquire) == x) return false;
+            }
+        }
+        /// number of disjoint sets, exact once no unite is running
+        inline std::size_t count() const {
+            return m_count.load(std::memory_order_relaxed);
+        }
+        inline std::size_t size() const {
+            return m_parent.size();
+        }
+    };
 
+    /// DisjointSets over arbitrary elements, each one is mapped to its handle
+    /// once by a hash index so find and unionize stay O(alpha(n))
+    template<typename T, typename H = std::hash<T>>
+    class UnionFind {
+        std::vector<T> m_content{};
+        std::unordered_map<T, std::size_t, H> m_index{};
+        DisjointSets m_sets{};
+    public:
+        inline UnionFind(const std::vector<T>& v): UnionFind(v.data(), v.size()) {}
+        inline UnionFind(const T* arr, size_t sz) : m_content(arr, arr + sz), m_sets(sz) {
+            static_assert(std::is_copy_assignable_v<T>, "T must be copy assignable");
+            m_index.reserve(sz);
+            for(size_t i = 0; i < sz; i++){
+                m_index.emplace(arr[i], i);
+            }
         }
 
+        /// handle of elem, size() when elem is unknown
+        inline size_t index(const T& elem) const {
+            auto it = m_index.find(elem);
+            return it == m_index.end() ? size() : it->second;
+        }
+        /// representative of the set holding elem, nullptr when elem is unknown
+        inline T* find(const T& elem){
+            if(auto idx = index(elem); idx < size()) {
+                return &m_content[m_sets.find(idx)];
+            } else {
+                return nullptr;
+            }
+        }
+        /// false when x and y already were in the same set or one is unknown
+        inline bool unionize(const T& x, const T& y){
+            size_t x_idx = index(x);
+            size_t y_idx = index(y);
+            if(x_idx >= size() || y_idx >= size()) return false;
+            return m_sets.unite(x_idx, y_idx);
+        }
+        inline bool same_set(const T& x, const T& y){
+            size_t x_idx = index(x);
+            size_t y_idx = index(y);
+            return x_idx < size() && y_idx < size() && m_sets.same_set(x_idx, y_idx);
+        }
+        /// elements in the set holding elem, 0 when elem is unknown
+        inline size_t set_size(const T& elem){
+            auto idx = index(elem);
+            return idx < size() ? m_sets.set_size(idx) : 0;
+        }
+        /// number of disjoint sets
+        inline size_t count() const {
+            return m_sets.count();
+        }
+        inline size_t size() const {
+            return m_content.size();
+        }
+        /// handle level access, handles are the positions in the constructor input
+        inline DisjointSets& sets() {
+            return m_sets;
+        }
     };
 
 }
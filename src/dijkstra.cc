@@ -160,18 +160,25 @@ void test_dijkstra(bool broken = false) {
     }
 
     auto d_sh_p_h = gr::dijkstra_shortest_path_h(graph, start, end);
+    auto d_bi = gr::bidirectional_dijkstra_shortest_path(graph, start, end);
+    auto d_astar = gr::astar_shortest_path(graph, start, end, [](node_t*) { return std::size_t{0}; });
     if(!broken){
         assert(path.size() == d_sh_p.size() && d_sh_p.size() == d_sh_p_h.size());
+        assert(path.size() == d_bi.size() && path.size() == d_astar.size());
     }
 
     if(broken){
         assert(d_sh_p.size() == 0 && "dijkstra_shortest_path was not empty for broken path variant");
         assert(d_sh_p_h.size() == 0 && "dijkstra_shortest_path_h was not empty for broken path variant");
+        assert(d_bi.size() == 0 && "bidirectional_dijkstra_shortest_path was not empty for broken path variant");
+        assert(d_astar.size() == 0 && "astar_shortest_path was not empty for broken path variant");
         return;
     }
     for(std::size_t i = 0; i < path.size(); i++){
         assert(path[i] == d_sh_p[i] && "dijkstra_shortest_path incorrect");
         assert(path[i] == d_sh_p_h[i] && "dijkstra_shortest_path_h incorrect");
+        assert(path[i] == d_bi[i] && "bidirectional_dijkstra_shortest_path incorrect");
+        assert(path[i] == d_astar[i] && "astar_shortest_path incorrect");
     }
 
 }
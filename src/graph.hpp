@@ -9,6 +9,7 @@
 #include <deque>
 #include <list>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <cstdio>
 #include <stdexcept>
@@ -209,7 +210,7 @@ namespace gr {
         for(auto& edge : v->edges) {
             auto endpoint = (rev ? edge->tail : edge->head);
             if (!static_cast<TopoSortableGraphData*>(&endpoint->node_data)->explored) {
-                dfs_topo<T>(endpoint, label);
+                dfs_topo<T>(endpoint, label, rev);
             }
         }
         e_ex->f_value = label;
@@ -227,63 +228,74 @@ namespace gr {
             }
         }
     }
-    namespace {
-        template <typename T, typename N = Graph<T>::node_t>
-        inline void dfs_topo_rev_for_scc(N* v, std::size_t& label, std::vector<N*>& order) {
-            static_assert(std::is_convertible<T*, SCCGraphData*>::value, "T must be derived from ExplorableGraphData");
-
-            auto* e_ex = static_cast<SCCGraphData*>(&v->node_data);
-            e_ex->explored = true;
-
-            for(auto& edge : v->edges) {
-                auto endpoint = edge->tail;
-                if (!static_cast<SCCGraphData*>(&endpoint->node_data)->explored) {
-                    dfs_topo_rev_for_scc<T>(endpoint, label, order);
-                }
-            }
-            e_ex->f_value = label;
-            order[label] = v;
-            label--;
-        }
-        template <typename T, typename N = Graph<T>::node_t>
-        inline void dfs_scc(N* v) {
-            static_assert(std::is_convertible<T*, SCCGraphData*>::value, "T must be derived from ExplorableGraphData");
-
-            auto* e_ex = static_cast<SCCGraphData*>(&v->node_data);
-            e_ex->explored = true;
-
-            for(auto& edge : v->edges) {
-                auto endpoint = edge->head;
-                if (auto scc_data_ptr = static_cast<SCCGraphData*>(&endpoint->node_data); !scc_data_ptr->explored) {
-                    scc_data_ptr->scc_n = e_ex->scc_n;
-                    dfs_scc<T>(endpoint);
-                }
-            }
-        }
-    }
-    template <typename T, typename N = Graph<T>::node_t>
-    inline void strongly_connected(Graph<T>& graph) {
-        static_assert(std::is_convertible<T*, SCCGraphData*>::value, "T must be derived from ExplorableGraphData");
+    /// Tarjan's algorithm in a single iterative dfs, so long paths cannot
+    /// overflow the stack. Components are numbered densely from 0 in reverse
+    /// topological order (sink components first) into scc_n, f_value holds
+    /// the dfs discovery index afterwards. Returns the size of every component
+    template <typename T, typename E, typename N = Graph<T, E>::node_t>
+    inline std::vector<std::size_t> strongly_connected(Graph<T, E>& graph) {
+        static_assert(std::is_convertible<T*, SCCGraphData*>::value, "T must be derived from SCCGraphData");
+        using edge_it = std::list<typename Graph<T, E>::edge_t*>::iterator;
+        /// scc_n of vertices still on the tarjan stack
+        constexpr auto OPEN = std::numeric_limits<std::size_t>::max();
 
-        auto current_label = graph.nodes.size();
-        std::vector<N*> order(current_label--);
-
-        for (auto& v : graph.nodes) {
-            if (!static_cast<SCCGraphData*>(&v.node_data)->explored) {
-                dfs_topo_rev_for_scc<T>(&v, current_label, order);
-            }
+        for(auto& v : graph.nodes) {
+            static_cast<SCCGraphData*>(&v.node_data)->explored = false;
         }
-        std::for_each(order.begin(), order.end(), [&](auto& v){
-            v->node_data.explored = false;
-        });
-        std::size_t scc = 0;
-        for (auto v_ptr : order) {
-            if (auto nd_as_scc = static_cast<SCCGraphData*>(&v_ptr->node_data); !nd_as_scc->explored) {
-                nd_as_scc->scc_n = scc;
-                dfs_scc<T>(v_ptr);
-                scc++;
+        // lowlinks by discovery index
+        std::vector<std::size_t> low{};
+        low.reserve(graph.nodes.size());
+        std::vector<N*> open{};
+        std::vector<std::pair<N*, edge_it>> call{};
+        std::vector<std::size_t> sizes{};
+
+        auto data = [](N* v) { return static_cast<SCCGraphData*>(&v->node_data); };
+        auto visit = [&](N* v) {
+            auto* d = data(v);
+            d->explored = true;
+            d->f_value = low.size();
+            d->scc_n = OPEN;
+            low.push_back(d->f_value);
+            open.push_back(v);
+            call.emplace_back(v, v->edges.begin());
+        };
+        for(auto& root : graph.nodes) {
+            if(data(&root)->explored) continue;
+            visit(&root);
+            while(!call.empty()) {
+                auto v = call.back().first;
+                auto& it = call.back().second;
+                if(it != v->edges.end()) {
+                    auto* e = *it++;
+                    if(e->tail != v) continue;
+                    auto* w = data(e->head);
+                    if(!w->explored) {
+                        visit(e->head);
+                    } else if(w->scc_n == OPEN) {
+                        low[data(v)->f_value] = std::min(low[data(v)->f_value], w->f_value);
+                    }
+                    continue;
+                }
+                call.pop_back();
+                auto index = data(v)->f_value;
+                if(!call.empty()) {
+                    auto parent = data(call.back().first)->f_value;
+                    low[parent] = std::min(low[parent], low[index]);
+                }
+                if(low[index] != index) continue;
+                // v is the root of a component, everything above it on the stack belongs to it
+                std::size_t size = 0;
+                N* w = nullptr;
+                do {
+                    w = open.back();
+                    open.pop_back();
+                    data(w)->scc_n = sizes.size();
+                    size++;
+                } while(w != v);
+                sizes.push_back(size);
             }
         }
+        return sizes;
     }
 
     template <typename T, typename N = Graph<T>::node_t>
@@ -510,52 +522,170 @@ namespace gr {
         }
         return path;
     }
+    /// point to point variant of dijkstra_shortest_path_h that searches forward
+    /// from start and backward from end (over Edge::tail) at the same time and
+    /// stops once the two queue minima add up to the best meeting distance.
+    /// Search state is kept in local maps, node data is not touched.
+    /// Like dijkstra_shortest_path_h the path is returned from end to start
+    template <typename T, typename E,
+             typename G = Graph<T, E>,
+             typename N = G::node_t,
+             typename ED = G::edge_t>
+    inline std::vector<N*> bidirectional_dijkstra_shortest_path(Graph<T, E>&, N* start, N* end) {
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from DijkstraEdge");
+        constexpr auto INF = std::numeric_limits<std::size_t>::max();
+
+        struct Side {
+            bool forward;
+            std::unordered_map<N*, std::size_t> len{};
+            std::unordered_map<N*, N*> prev{};
+            std::unordered_map<N*, bool> settled{};
+            dt::MinHeap<std::size_t, N*> heap{};
+
+            inline std::size_t distance(N* v) const {
+                auto it = len.find(v);
+                return it == len.end() ? INF : it->second;
+            }
+            /// pops stale entries, false once the queue is exhausted
+            inline bool prune() {
+                while(!heap.empty() && settled.contains(std::get<1>(heap.top()))) {
+                    heap.extract();
+                }
+                return !heap.empty();
+            }
+        };
+        std::vector<N*> path{};
+        if(start == end) {
+            path.push_back(start);
+            return path;
+        }
+        Side fwd{ .forward = true };
+        Side bwd{ .forward = false };
+        fwd.len[start] = 0;
+        fwd.prev[start] = nullptr;
+        fwd.heap.insert(0, start);
+        bwd.len[end] = 0;
+        bwd.prev[end] = nullptr;
+        bwd.heap.insert(0, end);
+
+        auto mu = INF;
+        N* meet = nullptr;
+        while(fwd.prune() && bwd.prune()) {
+            if(mu != INF && std::get<0>(fwd.heap.top()) + std::get<0>(bwd.heap.top()) >= mu) break;
+            auto& side = fwd.heap.size() <= bwd.heap.size() ? fwd : bwd;
+            auto& other = &side == &fwd ? bwd : fwd;
+
+            auto [k, v] = side.heap.extract();
+            side.settled[v] = true;
+            for(auto* e : v->edges) {
+                // node lists hold both directions, keep the ones leaving v in this search's direction
+                if((side.forward ? e->tail : e->head) != v) continue;
+                auto* u = side.forward ? e->head : e->tail;
+                if(side.settled.contains(u)) continue;
+                auto candidate = k + e->edge_data.dijkstra_score;
+                if(candidate < side.distance(u)) {
+                    side.len[u] = candidate;
+                    side.prev[u] = v;
+                    side.heap.insert(candidate, u);
+                }
+                if(auto rest = other.distance(u); rest != INF && side.len[u] + rest < mu) {
+                    mu = side.len[u] + rest;
+                    meet = u;
+                }
+            }
+        }
+        if(!meet) return path;
+        for(auto* v = bwd.prev[meet]; v; v = bwd.prev[v]) {
+            path.push_back(v);
+        }
+        std::reverse(path.begin(), path.end());
+        for(auto* v = meet; v; v = fwd.prev[v]) {
+            path.push_back(v);
+        }
+        return path;
+    }
+    /// A* search from start to end, heuristic(N*) must never overestimate the
+    /// remaining distance to end. Vertices whose distance improves after they
+    /// were expanded are expanded again, so an admissible but inconsistent
+    /// heuristic still gives a shortest path. Node data is not touched and the
+    /// path is returned from end to start like dijkstra_shortest_path_h
+    template <typename T, typename E, typename H,
+             typename G = Graph<T, E>,
+             typename N = G::node_t,
+             typename ED = G::edge_t>
+    inline std::vector<N*> astar_shortest_path(Graph<T, E>&, N* start, N* end, H&& heuristic) {
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from DijkstraEdge");
+
+        std::unordered_map<N*, std::size_t> len{};
+        std::unordered_map<N*, N*> prev{};
+        // key is the distance so far plus the estimate of what is left
+        dt::MinHeap<std::size_t, N*> heap{};
+        std::vector<N*> path{};
+
+        len[start] = 0;
+        prev[start] = nullptr;
+        heap.insert(heuristic(start), start);
+        while(!heap.empty()) {
+            auto [f, v] = heap.extract();
+            auto g = len[v];
+            // stale entry, v was queued again with a better distance
+            if(f != g + heuristic(v)) continue;
+            if(v == end) {
+                for(auto* w = end; w; w = prev[w]) {
+                    path.push_back(w);
+                }
+                return path;
+            }
+            for(auto* e : v->edges) {
+                if(e->tail != v) continue;
+                auto candidate = g + e->edge_data.dijkstra_score;
+                if(auto it = len.find(e->head); it == len.end() || candidate < it->second) {
+                    // the heuristic may report end as unreachable with the max value
+                    auto estimate = heuristic(e->head);
+                    if(estimate == std::numeric_limits<std::size_t>::max()) continue;
+                    len[e->head] = candidate;
+                    prev[e->head] = v;
+                    heap.insert(candidate + estimate, e->head);
+                }
+            }
+        }
+        return path;
+    }
     template <typename T, typename E,
              typename G = Graph<T, E>,
              typename N = G::node_t,
              typename ED = G::edge_t,
              typename DData = G::dijkstra_data_t>
     inline std::vector<ED*> prim_mst_heap(Graph<T, E>& gr, N* start) {
-        static_assert(std::is_convertible<T*, gr::ExplorableGraphData*>::value, "T must be derived from gr::ExplorableGraphData");
         static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from gr::DijkstraEdge");
         using edge_t = ED;
         using node_t = N;
-        dt::MinHeap<size_t, node_t*> heap;
-
-        std::vector<edge_t*> tree{};
-        std::vector<node_t*> x = { start };
-        x[0]->node_data.explored = true;
 
-        constexpr const size_t INF = std::numeric_limits<size_t>::max();
-        for(edge_t* edge : x[0]->edges){
-            edge->head->node_data.winner = edge;
-            heap.insert(edge->edge_data.dijkstra_score, edge->head);
-        }
+        // nodes are numbered once, the heap and the winner edges live here and not in the node data
+        std::vector<node_t*> nodes{};
+        std::unordered_map<node_t*, size_t> ids{};
+        nodes.reserve(gr.nodes.size());
+        ids.reserve(gr.nodes.size());
         for(node_t& node : gr.nodes){
-            if(&node != x[0] && !node.node_data.winner){
-                heap.insert(INF, &node);
-            }
+            ids.emplace(&node, nodes.size());
+            nodes.push_back(&node);
         }
+        std::vector<bool> explored(nodes.size());
+        std::vector<edge_t*> winner(nodes.size(), nullptr);
+        dt::IndexedHeap<size_t> heap{ nodes.size() };
+
+        std::vector<edge_t*> tree{};
+        heap.push(ids.at(start), 0);
         while(!heap.empty()){
-            auto [score, w] = heap.extract();
-            if(!w || w->node_data.explored) continue;
-            x.push_back(w);
-            tree.push_back(w->node_data.winner);
-            w->node_data.explored = true;
-
-            for(auto* e : w->edges){
-                if(e->tail == w && !e->head->node_data.explored){
-                    size_t cost = INF;
-                    // if the winner of head is NULL, cost is INF
-                    if(!e->head->node_data.winner)
-                        cost = INF;
-                    else
-                        cost = e->head->node_data.winner->edge_data.dijkstra_score;
-                    if(e->edge_data.dijkstra_score < cost){
-                        heap.delete_element(&e->head);
-                        e->head->node_data.winner = e;
-                        heap.insert(e->edge_data.dijkstra_score, e->head);
-                    }
+            auto [score, v] = heap.extract();
+            explored[v] = true;
+            if(winner[v]) tree.push_back(winner[v]);
+
+            for(auto* e : nodes[v]->edges){
+                if(e->tail != nodes[v]) continue;
+                auto h = ids.at(e->head);
+                if(!explored[h] && heap.push_or_decrease(h, e->edge_data.dijkstra_score)){
+                    winner[h] = e;
                 }
             }
         }
@@ -577,15 +707,19 @@ namespace gr {
         std::vector<ED*> tree{};
         dt::UnionFind<N*> union_find{ vertices };
 
-        gr.edges.sort([](ED a, ED b) { return a.edge_data.dijkstra_score < b.edge_data.dijkstra_score; });
-
+        // sort (score, position) pairs instead of the edge list, the graph stays as it is
+        std::vector<ED*> edges{};
+        std::vector<std::pair<size_t, size_t>> order{};
         for(ED& e : gr.edges){
-            auto v = union_find.find(e.tail);
-            auto w = union_find.find(e.head);
-            if(v != w) {
-                tree.push_back(&e);
+            order.emplace_back(e.edge_data.dijkstra_score, edges.size());
+            edges.push_back(&e);
+        }
+        std::sort(order.begin(), order.end());
+
+        for(auto [score, idx] : order){
+            if(union_find.unionize(edges[idx]->tail, edges[idx]->head)) {
+                tree.push_back(edges[idx]);
             }
-            union_find.unionize(*v, *w);
         }
         return tree;
     }
@@ -0,0 +1,134 @@
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_apsp.hpp>
+#include <graph_csr.hpp>
+#include <vector>
+
+struct EdgeData : public gr::DijkstraEdge {
+    EdgeData(decltype(gr::DijkstraEdge::dijkstra_score) s) : gr::DijkstraEdge(s) {}
+    EdgeData() {}
+};
+struct NodeData : public gr::Graph<NodeData, EdgeData>::DijkstraData {
+    NodeData(){}
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// checks next hops against the distances, the path has to be a walk of exactly that length
+template <typename W>
+void verify_paths(const gr::CSRGraph<W>& g, const gr::csr::APSPMatrix<W>& apsp) {
+    auto const n = g.vertex_count();
+    for(vertex_t i = 0; i < n; i++) {
+        for(vertex_t j = 0; j < n; j++) {
+            auto path = apsp.path(i, j);
+            if(apsp.distance(i, j) == gr::CSRGraph<W>::INF) {
+                assert(path.empty() && apsp.next_hop(i, j) == gr::CSRGraph<W>::NIL);
+                continue;
+            }
+            assert(path.front() == i && path.back() == j);
+            W len = 0;
+            for(std::size_t p = 1; p < path.size(); p++) {
+                auto best = gr::CSRGraph<W>::INF;
+                for(auto slot = g.edge_begin(path[p - 1]); slot < g.edge_end(path[p - 1]); slot++) {
+                    if(g.head(slot) == path[p]) best = std::min(best, g.weight(slot));
+                }
+                assert(best != gr::CSRGraph<W>::INF && "next hop follows a missing arc");
+                len += best;
+            }
+            assert(len == apsp.distance(i, j) && "next hop path has the wrong length");
+        }
+    }
+}
+
+void test_apsp_matches_dijkstra() {
+    std::size_t n = common::get_random_in_range(1, 130);
+    std::vector<csr_t::edge_tuple_t> arcs(common::get_random_in_range(0, 4 * n));
+    for(auto& arc : arcs) {
+        arc = {
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, 100),
+        };
+    }
+    auto g = csr_t::from_edges(n, arcs);
+    // tiles that do not divide n, a single tile and more workers than tiles
+    for(auto [tile, threads] : { std::tuple{ 1, 1 }, { 7, 3 }, { 16, 4 }, { 64, 1 }, { 256, 2 } }) {
+        auto apsp = gr::csr::APSPMatrix<>::from_graph(g, { .tile = std::size_t(tile), .threads = std::size_t(threads) });
+        assert(apsp.vertex_count() == n && !apsp.has_negative_cycle());
+        for(vertex_t s = 0; s < n; s++) {
+            auto len = gr::csr::dijkstra(g, s);
+            for(vertex_t v = 0; v < n; v++) {
+                assert(apsp.distance(s, v) == len[v] && "apsp differs from csr::dijkstra");
+            }
+        }
+        verify_paths(g, apsp);
+    }
+}
+
+void test_apsp_matrix_matches_dijkstra_h() {
+    std::size_t n = common::get_random_in_range(2, 40);
+    gr::Graph<NodeData, EdgeData>::vmatrix_e mtx(n);
+    for(auto& [data, row] : mtx) {
+        row.resize(n);
+        for(auto& [connected, e] : row) {
+            connected = common::get_random_in_range(1, 100) <= 30;
+            e = EdgeData(common::get_random_in_range(1, 50));
+        }
+    }
+    auto apsp = gr::csr::APSPMatrix<>::from_matrix(mtx, { .tile = 8, .threads = 2 });
+    auto graph = gr::Graph<NodeData, EdgeData>::from_matrix(mtx);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    for(vertex_t s = 0; s < n; s++) {
+        gr::dijkstra_h(graph, index.nodes[s]);
+        for(vertex_t v = 0; v < n; v++) {
+            assert(apsp.distance(s, v) == index.nodes[v]->node_data.len && "apsp differs from gr::dijkstra_h");
+        }
+    }
+}
+
+void test_apsp_negative_arcs() {
+    // w(u, v) + p(u) - p(v) keeps every cycle non-negative and shifts
+    // distances by p(s) - p(t)
+    std::size_t n = common::get_random_in_range(1, 60);
+    std::vector<long long> potential(n);
+    for(auto& p : potential) p = common::get_random_in_range(0, 50);
+    std::vector<csr_t::edge_tuple_t> arcs(common::get_random_in_range(0, 3 * n));
+    std::vector<gr::CSRGraph<long long>::edge_tuple_t> shifted{};
+    for(auto& arc : arcs) {
+        arc = {
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, 30),
+        };
+        auto [u, v, w] = arc;
+        shifted.emplace_back(u, v, static_cast<long long>(w) + potential[u] - potential[v]);
+    }
+    auto g = csr_t::from_edges(n, arcs);
+    auto h = gr::CSRGraph<long long>::from_edges(n, shifted);
+    auto apsp = gr::csr::APSPMatrix<long long>::from_graph(h, { .tile = 5, .threads = 3 });
+    assert(!apsp.has_negative_cycle());
+    for(vertex_t s = 0; s < n; s++) {
+        auto len = gr::csr::dijkstra(g, s);
+        for(vertex_t v = 0; v < n; v++) {
+            if(len[v] == csr_t::INF) {
+                assert(apsp.distance(s, v) == gr::CSRGraph<long long>::INF);
+            } else {
+                assert(apsp.distance(s, v) == static_cast<long long>(len[v]) + potential[s] - potential[v] && "negative arcs broke apsp");
+            }
+        }
+    }
+    verify_paths(h, apsp);
+
+    // a two vertex cycle of weight -1
+    auto cyclic = gr::CSRGraph<long long>::from_edges(2, std::vector<gr::CSRGraph<long long>::edge_tuple_t>{ { 0, 1, 2 }, { 1, 0, -3 } });
+    assert(gr::csr::APSPMatrix<long long>::from_graph(cyclic).has_negative_cycle() && "negative cycle not reported");
+}
+
+int main(void) {
+    for(auto i = 0; i < 20; i++) {
+        test_apsp_matches_dijkstra();
+        test_apsp_matrix_matches_dijkstra_h();
+        test_apsp_negative_arcs();
+    }
+}
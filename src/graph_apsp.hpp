@@ -0,0 +1,256 @@
+#ifndef GRAPH_APSP_HPP
+#define GRAPH_APSP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace gr::csr {
+    struct APSPOptions {
+        /// side of the square tiles, 64 keeps three size_t tiles in a 96KB L2 slice
+        std::size_t tile = 64;
+        /// workers for the independent tiles of a round, 0 uses std::thread::hardware_concurrency
+        std::size_t threads = 1;
+    };
+
+    /// all pairs shortest paths of a dense graph. The distance matrix is
+    /// padded to a whole number of tiles and stored row major together with
+    /// a next hop matrix (the vertex after i on the shortest i -> j path).
+    /// Negative arcs are fine as long as there is no negative cycle, which
+    /// shows up as a negative diagonal entry
+    template <typename W = std::size_t>
+    class APSPMatrix {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+    private:
+        /// infinity inside the solver, small enough that two of them do not
+        /// overflow, so the min-plus loops need no branches
+        inline static constexpr W FAR = std::is_floating_point_v<W> ? INF : INF / 2;
+        /// anything above this after solving is unreachable (FAR lowered by negative arcs)
+        inline static constexpr W UNREACHABLE = std::is_floating_point_v<W> ? INF : INF / 4;
+
+        std::size_t m_n{};
+        std::size_t m_tile{};
+        std::size_t m_stride{};
+        std::vector<W> m_len{};
+        std::vector<vertex_t> m_next{};
+
+        inline void init(std::size_t n, std::size_t tile) {
+            if(tile == 0) {
+                throw std::runtime_error("the tile size must be positive");
+            }
+            m_n = n;
+            m_tile = tile;
+            m_stride = (n + tile - 1) / tile * tile;
+            m_len.assign(m_stride * m_stride, FAR);
+            m_next.assign(m_stride * m_stride, NIL);
+            for(std::size_t v = 0; v < m_stride; v++) {
+                m_len[v * m_stride + v] = 0;
+                m_next[v * m_stride + v] = static_cast<vertex_t>(v);
+            }
+        }
+        inline void add_arc(std::size_t u, std::size_t v, W w) {
+            auto at = u * m_stride + v;
+            if(w < m_len[at]) {
+                m_len[at] = w;
+                m_next[at] = static_cast<vertex_t>(v);
+            }
+        }
+
+        /// c = min(c, a (x) b) over one k tile, a and b may be c itself.
+        /// The j loop is branch free over contiguous rows so it vectorizes
+        inline void min_plus(std::size_t ci, std::size_t cj, std::size_t ai, std::size_t bj, std::size_t k0) {
+            auto const T = m_tile;
+            auto const S = m_stride;
+            for(std::size_t k = k0; k < k0 + T; k++) {
+                const W* b = &m_len[k * S + bj];
+                for(std::size_t i = 0; i < T; i++) {
+                    auto aik = m_len[(ai + i) * S + k];
+                    if(!(aik < FAR)) continue;
+                    auto nik = m_next[(ai + i) * S + k];
+                    W* c = &m_len[(ci + i) * S + cj];
+                    vertex_t* nc = &m_next[(ci + i) * S + cj];
+                    for(std::size_t j = 0; j < T; j++) {
+                        auto candidate = aik + b[j];
+                        auto better = candidate < c[j];
+                        c[j] = better ? candidate : c[j];
+                        nc[j] = better ? nik : nc[j];
+                    }
+                }
+            }
+        }
+
+        /// blocked Floyd-Warshall, every round k first closes the diagonal
+        /// tile, then the tiles in its row and column, then all the others.
+        /// Tiles within the last two phases are independent of each other
+        inline void solve(std::size_t threads) {
+            auto const T = m_tile;
+            auto const tiles = m_stride / T;
+            if(tiles == 0) return;
+            threads = std::max<std::size_t>(1, std::min(worker_count(threads), (tiles - 1) * (tiles - 1)));
+
+            std::size_t round = 0;
+            // 0 diagonal, 1 row and column, 2 the rest
+            int phase = 0;
+            std::atomic<std::size_t> cursor{0};
+            bool done = false;
+
+            auto work_size = [&]() -> std::size_t {
+                if(phase == 0) return 1;
+                if(phase == 1) return 2 * (tiles - 1);
+                return (tiles - 1) * (tiles - 1);
+            };
+            auto run_item = [&](std::size_t item) {
+                auto const k0 = round * T;
+                if(phase == 0) {
+                    min_plus(k0, k0, k0, k0, k0);
+                    return;
+                }
+                if(phase == 1) {
+                    auto other = item % (tiles - 1);
+                    other = (other >= round ? other + 1 : other) * T;
+                    if(item < tiles - 1) {
+                        // row tile (k, j)
+                        min_plus(k0, other, k0, other, k0);
+                    } else {
+                        // column tile (i, k)
+                        min_plus(other, k0, other, k0, k0);
+                    }
+                    return;
+                }
+                auto i = item / (tiles - 1), j = item % (tiles - 1);
+                i = (i >= round ? i + 1 : i) * T;
+                j = (j >= round ? j + 1 : j) * T;
+                min_plus(i, j, i, j, k0);
+            };
+            // runs on one thread once everyone reached the barrier
+            auto next_phase = [&]() noexcept {
+                cursor.store(0, std::memory_order_relaxed);
+                if(++phase < 3 && tiles > 1) return;
+                phase = 0;
+                done = ++round == tiles;
+            };
+
+            std::barrier sync(static_cast<std::ptrdiff_t>(threads), next_phase);
+            auto worker = [&]() {
+                while(!done) {
+                    auto count = work_size();
+                    for(auto item = cursor.fetch_add(1, std::memory_order_relaxed); item < count;
+                            item = cursor.fetch_add(1, std::memory_order_relaxed)) {
+                        run_item(item);
+                    }
+                    sync.arrive_and_wait();
+                }
+            };
+            std::vector<std::thread> workers{};
+            for(std::size_t t = 1; t < threads; t++) {
+                workers.emplace_back(worker);
+            }
+            worker();
+            for(auto& w : workers) w.join();
+
+            for(std::size_t i = 0; i < m_n; i++) {
+                for(std::size_t j = 0; j < m_n; j++) {
+                    auto at = i * m_stride + j;
+                    if(UNREACHABLE < m_len[at]) {
+                        m_len[at] = INF;
+                        m_next[at] = NIL;
+                    }
+                }
+            }
+        }
+    public:
+        APSPMatrix() {}
+
+        inline static APSPMatrix from_graph(const CSRGraph<W>& g, APSPOptions opt = {}) {
+            APSPMatrix apsp{};
+            apsp.init(g.vertex_count(), opt.tile);
+            for(vertex_t v = 0; v < g.vertex_count(); v++) {
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    apsp.add_arc(v, g.head(slot), g.weight(slot));
+                }
+            }
+            apsp.solve(opt.threads);
+            return apsp;
+        }
+        /// vertex ids are the ids of the index
+        template <typename T, typename E>
+        inline static APSPMatrix from_graph(const GraphIndex<T, E>& index, APSPOptions opt = {}) {
+            return from_graph(CSRGraph<W>::from_graph(index), opt);
+        }
+        /// same input as Graph::from_matrix (vmatrix_e), filled in without building a graph
+        template <typename T, typename E>
+        inline static APSPMatrix from_matrix(const std::vector<std::tuple<T, std::vector<std::tuple<int, E>>>>& mtx,
+                APSPOptions opt = {}) {
+            auto const N = mtx.size();
+            APSPMatrix apsp{};
+            apsp.init(N, opt.tile);
+            for(std::size_t a = 0; a < N; a++) {
+                auto& row = std::get<1>(mtx[a]);
+                if(row.size() != N) {
+                    throw std::runtime_error("the matrix must be a square matrix");
+                }
+                for(std::size_t b = 0; b < N; b++) {
+                    if(a == b || std::get<0>(row[b]) != 1) continue;
+                    apsp.add_arc(a, b, static_cast<W>(edge_weight(std::get<1>(row[b]))));
+                }
+            }
+            apsp.solve(opt.threads);
+            return apsp;
+        }
+
+        inline std::size_t vertex_count() const {
+            return m_n;
+        }
+        /// INF when j is unreachable from i
+        inline W distance(vertex_t i, vertex_t j) const {
+            return m_len[i * m_stride + j];
+        }
+        /// vertex after i on the shortest i -> j path, NIL when unreachable
+        inline vertex_t next_hop(vertex_t i, vertex_t j) const {
+            return m_next[i * m_stride + j];
+        }
+        inline bool has_negative_cycle() const {
+            if constexpr (std::is_signed_v<W>) {
+                for(std::size_t v = 0; v < m_n; v++) {
+                    if(m_len[v * m_stride + v] < 0) return true;
+                }
+            }
+            return false;
+        }
+        /// vertices from i to j, empty when unreachable
+        inline std::vector<vertex_t> path(vertex_t i, vertex_t j) const {
+            std::vector<vertex_t> p{};
+            if(next_hop(i, j) == NIL) return p;
+            p.push_back(i);
+            for(auto v = i; v != j; v = next_hop(v, j)) {
+                p.push_back(next_hop(v, j));
+            }
+            return p;
+        }
+        /// row major distances, row i starts at i * stride()
+        inline const std::vector<W>& distances() const {
+            return m_len;
+        }
+        inline const std::vector<vertex_t>& next_hops() const {
+            return m_next;
+        }
+        inline std::size_t stride() const {
+            return m_stride;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_ch.hpp>
+#include <graph_csr.hpp>
+#include <vector>
+
+struct EdgeData : public gr::DijkstraEdge {
+    EdgeData(decltype(gr::DijkstraEdge::dijkstra_score) s) : gr::DijkstraEdge(s) {}
+    EdgeData() {}
+};
+struct NodeData : public gr::Graph<NodeData, EdgeData>::DijkstraData {
+    int id{};
+    NodeData(int n) : id(n) {}
+    NodeData(){}
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+void test_ch_matches_dijkstra() {
+    std::size_t n = common::get_random_in_range(1, 150);
+    std::vector<csr_t::edge_tuple_t> arcs(common::get_random_in_range(0, 600));
+    std::vector<std::size_t> refs(arcs.size());
+    for(std::size_t i = 0; i < arcs.size(); i++) {
+        arcs[i] = {
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, n - 1),
+            common::get_random_in_range(0, 100),
+        };
+        refs[i] = i;
+    }
+    auto g = csr_t::from_edges(n, arcs, refs);
+    auto ch = gr::csr::ContractionHierarchy<std::size_t>::build(g);
+    gr::csr::CHQuery<std::size_t> query{ ch };
+
+    for(auto q = 0; q < 20; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        auto expected = gr::csr::dijkstra(g, s);
+        for(auto k = 0; k < 5; k++) {
+            vertex_t t = common::get_random_in_range(0, n - 1);
+            auto d = query.run(s, t);
+            assert(d == expected[t] && "contraction hierarchy query differs from csr::dijkstra");
+
+            auto path = query.path_refs();
+            if(d == csr_t::INF || s == t) {
+                assert(path.empty());
+                continue;
+            }
+            // the unpacked path is a walk over input arcs
+            std::size_t len = 0;
+            auto at = s;
+            for(auto ref : path) {
+                auto [tail, head, w] = arcs[ref];
+                assert(tail == at && "unpacked path is not a walk");
+                len += w;
+                at = head;
+            }
+            assert(at == t && len == d && "unpacked path has the wrong length");
+        }
+    }
+}
+
+void test_ch_on_graph() {
+    using graph_t = gr::Graph<NodeData, EdgeData>;
+    graph_t::vmatrix_e mtx = {{
+        //       a       b       c       d       e       f
+        { 0, { {0, 0}, {1, 7}, {1, 9}, {0, 0}, {0, 0}, {1, 14} } },
+        { 1, { {0, 0}, {0, 0}, {1, 10}, {1, 15}, {0, 0}, {0, 0} } },
+        { 2, { {0, 0}, {0, 0}, {0, 0}, {1, 11}, {0, 0}, {1, 2} } },
+        { 3, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 6}, {0, 0} } },
+        { 4, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0} } },
+        { 5, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 9}, {0, 0} } },
+    }};
+    auto graph = graph_t::from_matrix(mtx);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto csr = csr_t::from_graph(index);
+    auto ch = gr::csr::ContractionHierarchy<std::size_t>::build(csr);
+    gr::csr::CHQuery<std::size_t> query{ ch };
+
+    auto start = index.id(&graph.nodes.front());
+    gr::dijkstra(graph, index.nodes[start]);
+    for(std::size_t v = 0; v < index.nodes.size(); v++) {
+        auto d = query.run(start, v);
+        assert(d == index.nodes[v]->node_data.len && "contraction hierarchy differs from gr::dijkstra");
+        auto edges = query.path_edges(index);
+        auto* at = index.nodes[start];
+        for(auto* e : edges) {
+            assert(e->tail == at && "path edges do not form a walk");
+            at = e->head;
+        }
+        assert(at == index.nodes[v]);
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 50; i++) {
+        test_ch_matches_dijkstra();
+    }
+    test_ch_on_graph();
+}
@@ -0,0 +1,385 @@
+#ifndef GRAPH_CH_HPP
+#define GRAPH_CH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <datatypes.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    /// contraction hierarchy over a static CSRGraph. Vertices are contracted
+    /// one by one in order of importance, and whenever removing v would break
+    /// the only shortest path u -> v -> x a shortcut u -> x is added. A query
+    /// then only has to search upwards (towards more important vertices) from
+    /// both ends, which settles a tiny part of the graph.
+    template <typename W>
+    class ContractionHierarchy {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+        inline static constexpr std::size_t NO_ARC = std::numeric_limits<std::size_t>::max();
+
+        /// an input arc (ref is its CSRGraph::edge_ref) or a shortcut standing
+        /// for the arcs first and second
+        struct Arc {
+            vertex_t tail{};
+            vertex_t head{};
+            W weight{};
+            std::size_t ref{NO_ARC};
+            std::size_t first{NO_ARC};
+            std::size_t second{NO_ARC};
+            /// false once a lighter parallel arc replaced this one
+            bool active{true};
+        };
+        struct Options {
+            /// witness searches give up after settling this many vertices and
+            /// add the shortcut, which is always safe
+            std::size_t witness_settle_limit = 500;
+        };
+    private:
+        std::vector<Arc> m_arcs{};
+        std::vector<std::size_t> m_rank{};
+        /// arcs from v to higher ranked heads, slot refs are arc ids
+        CSRGraph<W> m_up{};
+        /// reversed arcs into v from higher ranked tails, slot refs are arc ids
+        CSRGraph<W> m_down{};
+        std::size_t m_shortcuts{};
+
+        /// mutable graph the contraction runs on, contracted vertices are
+        /// removed from the adjacency of their neighbours
+        struct Builder {
+            ContractionHierarchy& ch;
+            Options opt;
+            /// (other endpoint, arc id)
+            std::vector<std::vector<std::pair<vertex_t, std::size_t>>> out{};
+            std::vector<std::vector<std::pair<vertex_t, std::size_t>>> in{};
+            std::vector<bool> contracted{};
+            std::vector<std::size_t> contracted_neighbours{};
+
+            // witness search state
+            std::vector<W> len{};
+            dt::EpochSet reached{};
+            dt::IndexedHeap<W> heap{};
+
+            /// adds tail -> head unless a parallel arc is at least as light
+            inline void add_arc(Arc arc) {
+                auto& arcs = ch.m_arcs;
+                for(auto& [head, id] : out[arc.tail]) {
+                    if(head != arc.head) continue;
+                    if(!(arc.weight < arcs[id].weight)) return;
+                    arcs[id].active = false;
+                    auto new_id = arcs.size();
+                    arcs.push_back(arc);
+                    id = new_id;
+                    for(auto& [tail, in_id] : in[arc.head]) {
+                        if(tail == arc.tail) in_id = new_id;
+                    }
+                    return;
+                }
+                out[arc.tail].emplace_back(arc.head, arcs.size());
+                in[arc.head].emplace_back(arc.tail, arcs.size());
+                arcs.push_back(arc);
+            }
+            /// dijkstra from source over the remaining graph without skip,
+            /// stops past max_len or at the settle limit
+            inline void witness_search(vertex_t source, vertex_t skip, W max_len) {
+                auto& arcs = ch.m_arcs;
+                reached.clear();
+                heap.clear();
+                reached.insert(source);
+                len[source] = 0;
+                heap.push(source, 0);
+                std::size_t settled = 0;
+                while(!heap.empty() && settled < opt.witness_settle_limit) {
+                    auto [k, idx] = heap.extract();
+                    if(max_len < k) break;
+                    settled++;
+                    for(auto& [head, id] : out[idx]) {
+                        if(head == skip) continue;
+                        auto candidate = k + arcs[id].weight;
+                        if(reached.try_insert(head) || candidate < len[head]) {
+                            len[head] = candidate;
+                            heap.push_or_decrease(head, candidate);
+                        }
+                    }
+                }
+            }
+            /// shortcuts contracting v needs, added to the graph unless dry_run
+            inline std::size_t contract(vertex_t v, bool dry_run) {
+                auto& arcs = ch.m_arcs;
+                std::size_t shortcuts = 0;
+                std::vector<Arc> pending{};
+                for(auto [u, in_id] : in[v]) {
+                    auto w1 = arcs[in_id].weight;
+                    W max_len = 0;
+                    for(auto [x, out_id] : out[v]) {
+                        if(x != u) max_len = std::max(max_len, w1 + arcs[out_id].weight);
+                    }
+                    if(out[v].empty() || (out[v].size() == 1 && out[v][0].first == u)) continue;
+                    witness_search(u, v, max_len);
+                    for(auto [x, out_id] : out[v]) {
+                        if(x == u) continue;
+                        auto via = w1 + arcs[out_id].weight;
+                        if(reached.contains(x) && !(via < len[x])) continue;
+                        shortcuts++;
+                        if(!dry_run) {
+                            pending.push_back(Arc{ .tail = u, .head = x, .weight = via, .first = in_id, .second = out_id });
+                        }
+                    }
+                }
+                for(auto& arc : pending) add_arc(arc);
+                return shortcuts;
+            }
+            /// edge difference plus the number of already contracted neighbours
+            inline std::int64_t priority(vertex_t v) {
+                auto shortcuts = static_cast<std::int64_t>(contract(v, true));
+                auto degree = static_cast<std::int64_t>(in[v].size() + out[v].size());
+                return shortcuts - degree + static_cast<std::int64_t>(contracted_neighbours[v]);
+            }
+            inline void remove(vertex_t v) {
+                contracted[v] = true;
+                for(auto [u, id] : in[v]) {
+                    std::erase_if(out[u], [&](auto& arc) { return arc.first == v; });
+                }
+                for(auto [x, id] : out[v]) {
+                    std::erase_if(in[x], [&](auto& arc) { return arc.first == v; });
+                }
+            }
+        };
+    public:
+        ContractionHierarchy() {}
+
+        inline static ContractionHierarchy build(const CSRGraph<W>& g, Options opt = {}) {
+            auto const n = g.vertex_count();
+            ContractionHierarchy ch{};
+            ch.m_rank.assign(n, 0);
+
+            Builder b{ .ch = ch, .opt = opt };
+            b.out.resize(n);
+            b.in.resize(n);
+            b.contracted.assign(n, false);
+            b.contracted_neighbours.assign(n, 0);
+            b.len.resize(n);
+            b.reached.resize(n);
+            b.heap.resize(n);
+            for(vertex_t v = 0; v < n; v++) {
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    if(g.head(slot) == v) continue;
+                    b.add_arc(Arc{ .tail = v, .head = g.head(slot), .weight = g.weight(slot), .ref = g.edge_ref(slot) });
+                }
+            }
+
+            // lazy updates: a popped vertex whose priority got worse goes back in
+            dt::IndexedHeap<std::int64_t> order(n);
+            for(vertex_t v = 0; v < n; v++) {
+                order.push(v, b.priority(v));
+            }
+            std::size_t next_rank = 0;
+            while(!order.empty()) {
+                auto v = static_cast<vertex_t>(std::get<1>(order.extract()));
+                auto p = b.priority(v);
+                if(!order.empty() && std::get<0>(order.top()) < p) {
+                    order.push(v, p);
+                    continue;
+                }
+                ch.m_shortcuts += b.contract(v, false);
+                ch.m_rank[v] = next_rank++;
+
+                std::vector<vertex_t> neighbours{};
+                for(auto [u, id] : b.in[v]) neighbours.push_back(u);
+                for(auto [x, id] : b.out[v]) neighbours.push_back(x);
+                b.remove(v);
+                std::sort(neighbours.begin(), neighbours.end());
+                neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+                for(auto u : neighbours) {
+                    b.contracted_neighbours[u]++;
+                    order.erase(u);
+                    order.push(u, b.priority(u));
+                }
+            }
+
+            std::vector<typename CSRGraph<W>::edge_tuple_t> up{}, down{};
+            std::vector<std::size_t> up_refs{}, down_refs{};
+            for(std::size_t id = 0; id < ch.m_arcs.size(); id++) {
+                auto& arc = ch.m_arcs[id];
+                if(!arc.active) continue;
+                if(ch.m_rank[arc.tail] < ch.m_rank[arc.head]) {
+                    up.emplace_back(arc.tail, arc.head, arc.weight);
+                    up_refs.push_back(id);
+                } else {
+                    down.emplace_back(arc.head, arc.tail, arc.weight);
+                    down_refs.push_back(id);
+                }
+            }
+            ch.m_up = CSRGraph<W>::from_edges(n, up, up_refs);
+            ch.m_down = CSRGraph<W>::from_edges(n, down, down_refs);
+            return ch;
+        }
+
+        inline std::size_t vertex_count() const {
+            return m_rank.size();
+        }
+        /// position of v in the contraction order
+        inline std::size_t rank(vertex_t v) const {
+            return m_rank[v];
+        }
+        inline std::size_t shortcut_count() const {
+            return m_shortcuts;
+        }
+        inline const std::vector<Arc>& arcs() const {
+            return m_arcs;
+        }
+        inline const CSRGraph<W>& upward() const {
+            return m_up;
+        }
+        inline const CSRGraph<W>& downward() const {
+            return m_down;
+        }
+        /// appends the input edge refs arc id stands for, in path order
+        inline void unpack(std::size_t id, std::vector<std::size_t>& refs) const {
+            std::vector<std::size_t> stack{ id };
+            while(!stack.empty()) {
+                auto& arc = m_arcs[stack.back()];
+                stack.pop_back();
+                if(arc.ref != NO_ARC) {
+                    refs.push_back(arc.ref);
+                } else {
+                    stack.push_back(arc.second);
+                    stack.push_back(arc.first);
+                }
+            }
+        }
+    };
+
+    /// point to point queries on a ContractionHierarchy, a forward search over
+    /// the upward arcs from the source meets a backward search over the
+    /// downward arcs from the target. State is reused between runs
+    template <typename W>
+    class CHQuery {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+    private:
+        struct Side {
+            const CSRGraph<W>* graph;
+            std::vector<W> len{};
+            std::vector<vertex_t> prev{};
+            std::vector<std::size_t> prev_slot{};
+            dt::EpochSet reached{};
+            dt::IndexedHeap<W> heap{};
+
+            inline void start(vertex_t from) {
+                auto const n = graph->vertex_count();
+                if(len.size() < n) {
+                    len.resize(n);
+                    prev.resize(n);
+                    prev_slot.resize(n);
+                    reached.resize(n);
+                    heap.resize(n);
+                }
+                reached.clear();
+                heap.clear();
+                reached.insert(from);
+                len[from] = 0;
+                prev[from] = NIL;
+                heap.push(from, 0);
+            }
+            inline W distance(vertex_t v) const {
+                return reached.contains(v) ? len[v] : INF;
+            }
+        };
+        const ContractionHierarchy<W>* m_ch;
+        Side m_fwd;
+        Side m_bwd;
+        vertex_t m_meet{NIL};
+        W m_mu{INF};
+        std::size_t m_settled_n{};
+
+        inline void step(Side& side, const Side& other) {
+            auto [k, idx] = side.heap.extract();
+            auto v = static_cast<vertex_t>(idx);
+            m_settled_n++;
+            if(auto rest = other.distance(v); rest != INF && k + rest < m_mu) {
+                m_mu = k + rest;
+                m_meet = v;
+            }
+            auto& g = *side.graph;
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                auto h = g.head(slot);
+                auto candidate = k + g.weight(slot);
+                if(side.reached.try_insert(h) || candidate < side.len[h]) {
+                    side.len[h] = candidate;
+                    side.prev[h] = v;
+                    side.prev_slot[h] = slot;
+                    side.heap.push_or_decrease(h, candidate);
+                }
+            }
+        }
+    public:
+        explicit CHQuery(const ContractionHierarchy<W>& ch) : m_ch(&ch), m_fwd{ &ch.upward() }, m_bwd{ &ch.downward() } {}
+
+        /// distance from source to target, INF when there is no path
+        inline W run(vertex_t source, vertex_t target) {
+            m_fwd.start(source);
+            m_bwd.start(target);
+            m_settled_n = 0;
+            m_mu = INF;
+            m_meet = NIL;
+            for(;;) {
+                auto f_min = m_fwd.heap.empty() ? INF : std::get<0>(m_fwd.heap.top());
+                auto b_min = m_bwd.heap.empty() ? INF : std::get<0>(m_bwd.heap.top());
+                // neither search can find anything shorter than mu any more
+                if(std::min(f_min, b_min) == INF || !(std::min(f_min, b_min) < m_mu)) break;
+                if(f_min <= b_min) {
+                    step(m_fwd, m_bwd);
+                } else {
+                    step(m_bwd, m_fwd);
+                }
+            }
+            return m_mu;
+        }
+        inline W distance() const {
+            return m_mu;
+        }
+        inline std::size_t settled_count() const {
+            return m_settled_n;
+        }
+        /// input edge refs of the shortest path from the source to the target
+        /// with every shortcut unpacked, empty when there is no path
+        inline std::vector<std::size_t> path_refs() const {
+            std::vector<std::size_t> refs{};
+            if(m_meet == NIL) return refs;
+            std::vector<std::size_t> up_arcs{};
+            for(auto v = m_meet; m_fwd.prev[v] != NIL; v = m_fwd.prev[v]) {
+                up_arcs.push_back(m_ch->upward().edge_ref(m_fwd.prev_slot[v]));
+            }
+            std::reverse(up_arcs.begin(), up_arcs.end());
+            for(auto id : up_arcs) {
+                m_ch->unpack(id, refs);
+            }
+            for(auto v = m_meet; m_bwd.prev[v] != NIL; v = m_bwd.prev[v]) {
+                m_ch->unpack(m_ch->downward().edge_ref(m_bwd.prev_slot[v]), refs);
+            }
+            return refs;
+        }
+        /// the unpacked path as edges of the gr::Graph the input CSRGraph was built from
+        template <typename T, typename E>
+        inline std::vector<typename Graph<T, E>::edge_t*> path_edges(const GraphIndex<T, E>& index) const {
+            std::vector<typename Graph<T, E>::edge_t*> edges{};
+            for(auto ref : path_refs()) {
+                edges.push_back(index.edges[ref]);
+            }
+            return edges;
+        }
+    };
+}
+
+#endif
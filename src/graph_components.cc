@@ -0,0 +1,192 @@
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_components.hpp>
+#include <graph_csr.hpp>
+#include <numeric>
+#include <vector>
+
+struct SCCNodeData : public gr::SCCGraphData {
+    SCCNodeData(){}
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// path 0 -> 1 -> ... -> n - 1, closed into a cycle when asked
+csr_t long_path(std::size_t n, bool closed) {
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(std::size_t v = 0; v + 1 < n; v++) arcs.emplace_back(v, v + 1, 1);
+    if(closed) arcs.emplace_back(n - 1, 0, 1);
+    return csr_t::from_edges(n, arcs);
+}
+
+void verify_decomposition(const csr_t& g, const gr::csr::SCCDecomposition& scc) {
+    assert(scc.sizes.size() == scc.count);
+    assert(std::accumulate(scc.sizes.begin(), scc.sizes.end(), std::size_t{0}) == g.vertex_count());
+    std::vector<std::size_t> sizes(scc.count);
+    for(auto c : scc.component) {
+        assert(c < scc.count && "component id is not dense");
+        sizes[c]++;
+    }
+    assert(sizes == scc.sizes && "component sizes are off");
+    for(vertex_t v = 0; v < g.vertex_count(); v++) {
+        for(auto w : g.neighbours(v)) {
+            assert(scc.component[v] >= scc.component[w] && "components are not in reverse topological order");
+        }
+    }
+}
+
+void test_tarjan_matches_kosaraju() {
+    std::size_t n = common::get_random_in_range(1, 300);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 2 * n));
+    auto scc = gr::csr::tarjan_scc(g);
+    auto expected = gr::csr::strongly_connected(g);
+    verify_decomposition(g, scc);
+    for(vertex_t a = 0; a < n; a++) {
+        for(vertex_t b = 0; b < n; b++) {
+            assert((expected[a] == expected[b]) == (scc.component[a] == scc.component[b]) && "tarjan_scc grouping differs");
+        }
+    }
+}
+
+void test_tarjan_deep_paths() {
+    std::size_t n = 1'000'000;
+    auto open = gr::csr::tarjan_scc(long_path(n, false));
+    assert(open.count == n && "a path is n trivial components");
+    auto closed = gr::csr::tarjan_scc(long_path(n, true));
+    assert(closed.count == 1 && closed.sizes[0] == n && "a cycle is a single component");
+}
+
+void test_graph_strongly_connected() {
+    using graph_t = gr::Graph<SCCNodeData>;
+    // a long cycle that used to overflow the recursive dfs, plus a random tail
+    std::size_t n = 200'000;
+    graph_t graph{};
+    std::vector<graph_t::node_t*> nodes(n);
+    for(auto& node : nodes) {
+        graph.nodes.push_back({ .edges = {}, .node_data = {} });
+        node = &graph.nodes.back();
+    }
+    auto link = [&](std::size_t a, std::size_t b) {
+        graph.edges.push_back({ .tail = nodes[a], .head = nodes[b], .edge_data = {} });
+        nodes[a]->edges.push_back(&graph.edges.back());
+        if(a != b) nodes[b]->edges.push_back(&graph.edges.back());
+    };
+    std::size_t cycle = common::get_random_in_range(2, n / 2);
+    for(std::size_t v = 0; v < cycle; v++) link(v, (v + 1) % cycle);
+    for(std::size_t v = cycle; v < n; v++) link(v - 1, v);
+    for(auto i = 0; i < 1000; i++) {
+        link(common::get_random_in_range(0, n - 1), common::get_random_in_range(0, n - 1));
+    }
+
+    auto sizes = gr::strongly_connected(graph);
+    gr::GraphIndex<SCCNodeData> index{ graph };
+    auto scc = gr::csr::tarjan_scc(csr_t::from_graph(index));
+    assert(sizes == scc.sizes && "gr::strongly_connected sizes differ from tarjan_scc");
+    for(vertex_t v = 0; v < n; v++) {
+        assert(index.nodes[v]->node_data.scc_n == scc.component[v] && "gr::strongly_connected ids differ from tarjan_scc");
+    }
+}
+
+/// one big cycle with random chords, random sparse arcs around it and some chains
+csr_t giant_component_graph(std::size_t n) {
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    std::size_t giant = common::get_random_in_range(0, n);
+    for(std::size_t v = 0; v < giant; v++) {
+        arcs.emplace_back(v, (v + 1) % giant, 1);
+        arcs.emplace_back(v, common::get_random_in_range(0, giant - 1), 1);
+    }
+    for(std::size_t i = 0; i < n; i++) {
+        arcs.emplace_back(common::get_random_in_range(0, n - 1), common::get_random_in_range(0, n - 1), 1);
+    }
+    for(std::size_t v = giant; v + 1 < n; v += 2) arcs.emplace_back(v, v + 1, 1);
+    return csr_t::from_edges(n, arcs);
+}
+
+void test_parallel_scc() {
+    std::size_t n = common::get_random_in_range(1, 3000);
+    auto g = common::get_random_in_range(0, 1) ? giant_component_graph(n) : common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 2 * n));
+    auto expected = gr::csr::tarjan_scc(g);
+    for(std::size_t threads : { 1, 4 }) {
+        auto scc = gr::csr::parallel_scc(g, threads);
+        assert(scc.count == expected.count && "parallel_scc found a different number of components");
+        // ids differ, the mapping between them has to be a bijection
+        std::vector<std::size_t> map(scc.count, gr::csr::SCCDecomposition::NONE);
+        for(vertex_t v = 0; v < n; v++) {
+            auto& m = map[scc.component[v]];
+            assert((m == gr::csr::SCCDecomposition::NONE || m == expected.component[v]) && "parallel_scc grouping differs");
+            m = expected.component[v];
+        }
+        for(std::size_t c = 0; c < scc.count; c++) {
+            assert(scc.sizes[c] == expected.sizes[map[c]] && "parallel_scc sizes differ");
+        }
+    }
+}
+
+void test_parallel_scc_matches_graph() {
+    using graph_t = gr::Graph<SCCNodeData>;
+    std::size_t n = common::get_random_in_range(1, 400);
+    graph_t graph{};
+    std::vector<graph_t::node_t*> nodes(n);
+    for(auto& node : nodes) {
+        graph.nodes.push_back({ .edges = {}, .node_data = {} });
+        node = &graph.nodes.back();
+    }
+    for(std::size_t i = 0; i < 2 * n; i++) {
+        auto* a = nodes[common::get_random_in_range(0, n - 1)];
+        auto* b = nodes[common::get_random_in_range(0, n - 1)];
+        graph.edges.push_back({ .tail = a, .head = b, .edge_data = {} });
+        a->edges.push_back(&graph.edges.back());
+        if(a != b) b->edges.push_back(&graph.edges.back());
+    }
+    gr::strongly_connected(graph);
+    gr::GraphIndex<SCCNodeData> index{ graph };
+    auto scc = gr::csr::parallel_scc(csr_t::from_graph(index), 3);
+    for(vertex_t a = 0; a < n; a++) {
+        for(vertex_t b = 0; b < n; b++) {
+            auto same = index.nodes[a]->node_data.scc_n == index.nodes[b]->node_data.scc_n;
+            assert(same == (scc.component[a] == scc.component[b]) && "parallel_scc grouping differs from gr::strongly_connected");
+        }
+    }
+}
+
+void test_condensation_and_reachability() {
+    std::size_t n = common::get_random_in_range(1, 150);
+    auto g = common::get_random_in_range(0, 1) ? giant_component_graph(n) : common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 2 * n));
+    auto cond = gr::csr::condense(g);
+    auto& dag = cond.dag;
+    assert(dag.vertex_count() == cond.scc.count);
+    for(vertex_t c = 0; c < dag.vertex_count(); c++) {
+        auto heads = dag.neighbours(c);
+        for(std::size_t i = 0; i < heads.size(); i++) {
+            assert(heads[i] < c && "condensation arc does not go to a lower component");
+            for(std::size_t j = 0; j < i; j++) assert(heads[i] != heads[j] && "parallel condensation arcs");
+        }
+    }
+
+    // tiny budgets leave part or all of the queries to the pruned search
+    std::vector<gr::csr::ReachabilityIndex<std::size_t>> indexes{};
+    indexes.emplace_back(cond);
+    indexes.emplace_back(cond, gr::csr::ReachabilityOptions{ .max_closure_bytes = 8 * cond.scc.count });
+    indexes.emplace_back(cond, gr::csr::ReachabilityOptions{ .max_closure_bytes = 0 });
+    assert(indexes[0].exact() && !indexes[2].exact());
+    for(vertex_t u = 0; u < n; u++) {
+        auto reached = gr::csr::bfs(g, u);
+        for(vertex_t v = 0; v < n; v++) {
+            for(auto& index : indexes) {
+                assert(index.reaches(u, v) == reached[v] && "reachability index is wrong");
+            }
+        }
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_tarjan_matches_kosaraju();
+        test_parallel_scc();
+        test_parallel_scc_matches_graph();
+        test_condensation_and_reachability();
+    }
+    test_tarjan_deep_paths();
+    test_graph_strongly_connected();
+}
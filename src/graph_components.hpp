@@ -0,0 +1,412 @@
+#ifndef GRAPH_COMPONENTS_HPP
+#define GRAPH_COMPONENTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    /// component id of every vertex, ids are dense in [0, count)
+    struct SCCDecomposition {
+        inline static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+        std::vector<std::size_t> component{};
+        std::size_t count{};
+        /// number of vertices in every component
+        std::vector<std::size_t> sizes{};
+    };
+
+    /// Tarjan's algorithm with an explicit call stack, one pass over the
+    /// arcs and no recursion. Components come out in reverse topological
+    /// order, so component 0 has no arcs to other components
+    template <typename W>
+    inline SCCDecomposition tarjan_scc(const CSRGraph<W>& g) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr auto NONE = SCCDecomposition::NONE;
+        auto const n = g.vertex_count();
+
+        SCCDecomposition scc{};
+        scc.component.assign(n, NONE);
+        // discovery index and lowlink, NONE for unvisited vertices
+        std::vector<std::size_t> index(n, NONE), low(n);
+        std::vector<vertex_t> open{};
+        std::vector<std::pair<vertex_t, std::size_t>> call{};
+        std::size_t next_index = 0;
+
+        auto visit = [&](vertex_t v) {
+            index[v] = low[v] = next_index++;
+            open.push_back(v);
+            call.emplace_back(v, g.edge_begin(v));
+        };
+        for(vertex_t root = 0; root < n; root++) {
+            if(index[root] != NONE) continue;
+            visit(root);
+            while(!call.empty()) {
+                auto& [v, slot] = call.back();
+                if(slot < g.edge_end(v)) {
+                    auto w = g.head(slot++);
+                    if(index[w] == NONE) {
+                        visit(w);
+                    } else if(scc.component[w] == NONE) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+                auto u = v;
+                call.pop_back();
+                if(!call.empty()) {
+                    auto parent = call.back().first;
+                    low[parent] = std::min(low[parent], low[u]);
+                }
+                if(low[u] != index[u]) continue;
+                std::size_t size = 0;
+                vertex_t w{};
+                do {
+                    w = open.back();
+                    open.pop_back();
+                    scc.component[w] = scc.count;
+                    size++;
+                } while(w != u);
+                scc.sizes.push_back(size);
+                scc.count++;
+            }
+        }
+        return scc;
+    }
+
+    /// parallel SCC decomposition for graphs made of one giant component and
+    /// many small ones. First vertices without live in- or out-arcs are
+    /// trimmed off as trivial components, then the forward and backward
+    /// reachable sets of a high degree pivot meet in the giant component,
+    /// and what is left is split by multi-pivot coloring: the highest vertex
+    /// id reaching a vertex becomes its color, and each color root collects
+    /// its component by a backward search inside its color. Every phase runs
+    /// level synchronously over a frontier split between the workers.
+    /// rev must be g.transpose(), threads == 0 uses std::thread::hardware_concurrency.
+    /// Component ids are dense but in no particular order
+    template <typename W>
+    inline SCCDecomposition parallel_scc(const CSRGraph<W>& g, const CSRGraph<W>& rev, std::size_t threads = 0) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        /// color of vertices that already have a component
+        constexpr vertex_t DONE = CSRGraph<W>::NIL;
+        auto const n = g.vertex_count();
+        threads = worker_count(threads);
+
+        SCCDecomposition scc{};
+        scc.component.assign(n, SCCDecomposition::NONE);
+        std::atomic<std::size_t> next_id{0};
+        std::vector<std::atomic<vertex_t>> color(n);
+        std::vector<vertex_t> all(n);
+        for(vertex_t v = 0; v < n; v++) {
+            color[v].store(v, std::memory_order_relaxed);
+            all[v] = v;
+        }
+        auto live = [&](vertex_t v) { return color[v].load(std::memory_order_relaxed) != DONE; };
+
+        // trimming, degrees only count arcs between live vertices, self loops never count
+        std::vector<std::atomic<std::size_t>> in_deg(n), out_deg(n);
+        std::vector<std::atomic<std::uint64_t>> trimmed((n + 63) / 64);
+        auto frontier = expand_frontier(all, threads, [&](vertex_t v, std::vector<vertex_t>& out) {
+            std::size_t in = 0, outs = 0;
+            for(auto u : rev.neighbours(v)) in += u != v;
+            for(auto w : g.neighbours(v)) outs += w != v;
+            in_deg[v].store(in, std::memory_order_relaxed);
+            out_deg[v].store(outs, std::memory_order_relaxed);
+            if((in == 0 || outs == 0) && claim(trimmed, v)) out.push_back(v);
+        });
+        while(!frontier.empty()) {
+            frontier = expand_frontier(frontier, threads, [&](vertex_t v, std::vector<vertex_t>& out) {
+                color[v].store(DONE, std::memory_order_relaxed);
+                scc.component[v] = next_id.fetch_add(1, std::memory_order_relaxed);
+                for(auto w : g.neighbours(v)) {
+                    if(w != v && in_deg[w].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(trimmed, w)) out.push_back(w);
+                }
+                for(auto u : rev.neighbours(v)) {
+                    if(u != v && out_deg[u].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(trimmed, u)) out.push_back(u);
+                }
+            });
+        }
+
+        std::vector<vertex_t> rest{};
+        for(vertex_t v = 0; v < n; v++) {
+            if(live(v)) rest.push_back(v);
+        }
+        if(rest.empty()) {
+            scc.count = next_id.load();
+            scc.sizes.assign(scc.count, 1);
+            return scc;
+        }
+
+        // forward-backward from the pivot most likely to sit in the giant component
+        auto pivot = *std::max_element(rest.begin(), rest.end(), [&](vertex_t a, vertex_t b) {
+            return in_deg[a].load(std::memory_order_relaxed) * out_deg[a].load(std::memory_order_relaxed) <
+                in_deg[b].load(std::memory_order_relaxed) * out_deg[b].load(std::memory_order_relaxed);
+        });
+        auto reach = [&](const CSRGraph<W>& graph, std::vector<std::atomic<std::uint64_t>>& seen) {
+            claim(seen, pivot);
+            std::vector<vertex_t> level{ pivot };
+            while(!level.empty()) {
+                level = expand_frontier(level, threads, [&](vertex_t v, std::vector<vertex_t>& out) {
+                    for(auto w : graph.neighbours(v)) {
+                        if(live(w) && claim(seen, w)) out.push_back(w);
+                    }
+                });
+            }
+        };
+        std::vector<std::atomic<std::uint64_t>> forward((n + 63) / 64), backward((n + 63) / 64);
+        reach(g, forward);
+        reach(rev, backward);
+        auto is_set = [](const std::vector<std::atomic<std::uint64_t>>& bits, vertex_t v) {
+            return (bits[v / 64].load(std::memory_order_relaxed) >> (v % 64)) & 1;
+        };
+        auto giant = next_id.fetch_add(1, std::memory_order_relaxed);
+        std::erase_if(rest, [&](vertex_t v) {
+            if(!is_set(forward, v) || !is_set(backward, v)) return false;
+            color[v].store(DONE, std::memory_order_relaxed);
+            scc.component[v] = giant;
+            return true;
+        });
+
+        // multi-pivot coloring until every vertex has its component
+        std::vector<std::atomic<std::uint64_t>> queued((n + 63) / 64);
+        while(!rest.empty()) {
+            for(auto v : rest) color[v].store(v, std::memory_order_relaxed);
+            frontier = rest;
+            while(!frontier.empty()) {
+                for(auto v : frontier) queued[v / 64].store(0, std::memory_order_relaxed);
+                frontier = expand_frontier(frontier, threads, [&](vertex_t v, std::vector<vertex_t>& out) {
+                    auto c = color[v].load(std::memory_order_relaxed);
+                    for(auto w : g.neighbours(v)) {
+                        auto current = color[w].load(std::memory_order_relaxed);
+                        bool raised = false;
+                        while(current < c && current != DONE) {
+                            if(color[w].compare_exchange_weak(current, c, std::memory_order_relaxed)) {
+                                raised = true;
+                                break;
+                            }
+                        }
+                        if(raised && claim(queued, w)) out.push_back(w);
+                    }
+                });
+            }
+            std::vector<vertex_t> roots{};
+            for(auto v : rest) {
+                if(color[v].load(std::memory_order_relaxed) == v) roots.push_back(v);
+            }
+            // colors are disjoint, so every root searches its own vertices
+            expand_frontier(roots, threads, [&](vertex_t root, std::vector<vertex_t>&) {
+                auto id = next_id.fetch_add(1, std::memory_order_relaxed);
+                std::vector<vertex_t> stack{ root };
+                color[root].store(DONE, std::memory_order_relaxed);
+                while(!stack.empty()) {
+                    auto v = stack.back();
+                    stack.pop_back();
+                    scc.component[v] = id;
+                    for(auto u : rev.neighbours(v)) {
+                        auto expected = root;
+                        if(color[u].compare_exchange_strong(expected, DONE, std::memory_order_relaxed)) {
+                            stack.push_back(u);
+                        }
+                    }
+                }
+            });
+            std::erase_if(rest, [&](vertex_t v) { return !live(v); });
+        }
+
+        scc.count = next_id.load();
+        scc.sizes.assign(scc.count, 0);
+        for(auto c : scc.component) scc.sizes[c]++;
+        return scc;
+    }
+    template <typename W>
+    inline SCCDecomposition parallel_scc(const CSRGraph<W>& g, std::size_t threads = 0) {
+        return parallel_scc(g, g.transpose(), threads);
+    }
+
+    /// graph of the strongly connected components, component c has the id
+    /// tarjan_scc gave it, so every arc goes from a higher id to a lower one.
+    /// Parallel arcs between two components are merged into the lightest,
+    /// whose input edge ref the dag slot keeps
+    template <typename W>
+    struct Condensation {
+        SCCDecomposition scc{};
+        CSRGraph<W> dag{};
+    };
+
+    template <typename W>
+    inline Condensation<W> condense(const CSRGraph<W>& g) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        Condensation<W> c{ .scc = tarjan_scc(g), .dag = {} };
+        auto& component = c.scc.component;
+
+        // (tail component, head component, weight, ref), lightest first within a pair
+        std::vector<std::tuple<vertex_t, vertex_t, W, std::size_t>> between{};
+        for(vertex_t v = 0; v < g.vertex_count(); v++) {
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                auto a = component[v], b = component[g.head(slot)];
+                if(a != b) between.emplace_back(a, b, g.weight(slot), g.edge_ref(slot));
+            }
+        }
+        std::sort(between.begin(), between.end());
+        std::vector<typename CSRGraph<W>::edge_tuple_t> arcs{};
+        std::vector<std::size_t> refs{};
+        for(std::size_t i = 0; i < between.size(); i++) {
+            auto& [a, b, w, ref] = between[i];
+            if(i > 0 && std::get<0>(between[i - 1]) == a && std::get<1>(between[i - 1]) == b) continue;
+            arcs.emplace_back(a, b, w);
+            refs.push_back(ref);
+        }
+        c.dag = CSRGraph<W>::from_edges(c.scc.count, arcs, refs);
+        return c;
+    }
+
+    struct ReachabilityOptions {
+        /// memory for the closure bits, every chunk costs 8 bytes per component
+        /// and covers 64 target components. When all components fit every
+        /// query is answered from the labels and bits alone
+        std::size_t max_closure_bytes = std::size_t{64} << 20;
+    };
+
+    /// "can u reach v" index over a Condensation. Every component gets
+    ///  - its position in the topological order, u after v means no,
+    ///  - a GRAIL interval [low, post] from a post-order dfs over the dag,
+    ///    v's interval not inside u's means no,
+    ///  - the dfs tree interval [first, post], v's post inside it means yes,
+    ///  - for target components, one bit per target in a few 64 bit chunks
+    ///    holding the exact closure (all components when memory allows,
+    ///    else the ones with the most arcs).
+    /// A query the labels cannot settle does a dfs pruned by the same labels
+    template <typename W>
+    class ReachabilityIndex {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+    private:
+        inline static constexpr std::size_t NO_BIT = std::numeric_limits<std::size_t>::max();
+
+        const Condensation<W>* m_cond;
+        std::vector<std::size_t> m_low{};
+        std::vector<std::size_t> m_first{};
+        std::vector<std::size_t> m_post{};
+        std::size_t m_chunks{};
+        /// m_chunks words per component
+        std::vector<std::uint64_t> m_closure{};
+        std::vector<std::size_t> m_bit{};
+        TraversalWorkspace m_ws{};
+
+        /// false when the labels rule out a reaches b
+        inline bool may_reach(std::size_t a, std::size_t b) const {
+            return a >= b && m_low[a] <= m_low[b] && m_post[b] <= m_post[a];
+        }
+        inline bool tree_reaches(std::size_t a, std::size_t b) const {
+            return m_first[a] <= m_post[b] && m_post[b] <= m_post[a];
+        }
+    public:
+        explicit ReachabilityIndex(const Condensation<W>& cond, ReachabilityOptions opt = {}) : m_cond(&cond) {
+            auto& dag = cond.dag;
+            auto const n = dag.vertex_count();
+            m_low.assign(n, 0);
+            m_first.assign(n, 0);
+            m_post.assign(n, 0);
+
+            // post-order dfs from every source, higher ids come first in topological order
+            std::vector<bool> explored(n);
+            std::vector<std::pair<vertex_t, std::size_t>> stack{};
+            std::size_t next_post = 0;
+            for(auto root = n; root-- > 0;) {
+                if(explored[root]) continue;
+                explored[root] = true;
+                m_first[root] = next_post;
+                stack.emplace_back(static_cast<vertex_t>(root), dag.edge_begin(root));
+                while(!stack.empty()) {
+                    auto& [v, slot] = stack.back();
+                    if(slot < dag.edge_end(v)) {
+                        auto w = dag.head(slot++);
+                        if(!explored[w]) {
+                            explored[w] = true;
+                            m_first[w] = next_post;
+                            stack.emplace_back(w, dag.edge_begin(w));
+                        }
+                        continue;
+                    }
+                    auto u = v;
+                    stack.pop_back();
+                    m_post[u] = next_post++;
+                    m_low[u] = m_first[u];
+                    for(auto w : dag.neighbours(u)) m_low[u] = std::min(m_low[u], m_low[w]);
+                }
+            }
+
+            // closure chunks, sinks first so successors are always done
+            m_chunks = std::min((n + 63) / 64, n ? opt.max_closure_bytes / (8 * n) : 0);
+            m_bit.assign(n, NO_BIT);
+            std::vector<vertex_t> targets(n);
+            for(vertex_t c = 0; c < n; c++) targets[c] = c;
+            if(m_chunks * 64 < n) {
+                auto arcs = [&](vertex_t c) { return dag.degree(c) + cond.scc.sizes[c]; };
+                std::partial_sort(targets.begin(), targets.begin() + m_chunks * 64, targets.end(),
+                        [&](vertex_t a, vertex_t b) { return arcs(a) > arcs(b); });
+                targets.resize(m_chunks * 64);
+            }
+            for(std::size_t i = 0; i < targets.size(); i++) m_bit[targets[i]] = i;
+            m_closure.assign(n * m_chunks, 0);
+            for(vertex_t c = 0; c < n && m_chunks; c++) {
+                auto* words = &m_closure[c * m_chunks];
+                if(m_bit[c] != NO_BIT) words[m_bit[c] / 64] |= std::uint64_t{1} << (m_bit[c] % 64);
+                for(auto w : dag.neighbours(c)) {
+                    auto* from = &m_closure[w * m_chunks];
+                    for(std::size_t k = 0; k < m_chunks; k++) words[k] |= from[k];
+                }
+            }
+        }
+
+        inline const Condensation<W>& condensation() const {
+            return *m_cond;
+        }
+        /// true when every query is answered without a search
+        inline bool exact() const {
+            return m_chunks * 64 >= m_post.size();
+        }
+        /// component a reaches component b, ws holds the state of a fallback search
+        inline bool component_reaches(std::size_t a, std::size_t b, TraversalWorkspace& ws) const {
+            if(a == b) return true;
+            if(!may_reach(a, b)) return false;
+            if(tree_reaches(a, b)) return true;
+            if(m_bit[b] != NO_BIT) {
+                return (m_closure[a * m_chunks + m_bit[b] / 64] >> (m_bit[b] % 64)) & 1;
+            }
+            auto& dag = m_cond->dag;
+            ws.fit(dag.vertex_count());
+            auto& stack = ws.queue;
+            stack.assign(1, static_cast<vertex_t>(a));
+            ws.explored.insert(a);
+            while(!stack.empty()) {
+                auto v = stack.back();
+                stack.pop_back();
+                for(auto w : dag.neighbours(v)) {
+                    if(w == b || (may_reach(w, b) && tree_reaches(w, b))) return true;
+                    if(!may_reach(w, b) || !ws.explored.try_insert(w)) continue;
+                    stack.push_back(w);
+                }
+            }
+            return false;
+        }
+        /// vertex u of the input graph reaches vertex v
+        inline bool reaches(vertex_t u, vertex_t v, TraversalWorkspace& ws) const {
+            auto& component = m_cond->scc.component;
+            return component_reaches(component[u], component[v], ws);
+        }
+        /// uses a workspace owned by the index, not safe to call from several threads
+        inline bool reaches(vertex_t u, vertex_t v) {
+            return reaches(u, v, m_ws);
+        }
+    };
+}
+
+#endif
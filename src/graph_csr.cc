@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <vector>
+
+struct EdgeData : public gr::DijkstraEdge {
+    EdgeData(decltype(gr::DijkstraEdge::dijkstra_score) s) : gr::DijkstraEdge(s) {}
+    EdgeData() {}
+};
+struct NodeData : public gr::Graph<NodeData, EdgeData>::DijkstraData {
+    int id{};
+    NodeData(int n) : id(n) {}
+    NodeData(){}
+};
+struct SCCNodeData : public gr::SCCGraphData {
+    int id{};
+    SCCNodeData(int n) : id(n) {}
+    SCCNodeData(){}
+};
+
+/// random directed graph, every edge is listed by both of its endpoints like in from_matrix
+template <typename T, typename E>
+gr::Graph<T, E> random_graph(int node_n, int edge_chance) {
+    using graph_t = gr::Graph<T, E>;
+    using node_t = graph_t::node_t;
+    using edge_t = graph_t::edge_t;
+    graph_t graph{};
+    std::vector<node_t*> nodes(node_n);
+    for(auto i = 0; i < node_n; i++) {
+        graph.nodes.push_back(node_t{ .edges = {}, .node_data = { i } });
+        nodes[i] = &graph.nodes.back();
+    }
+    for(auto a = 0; a < node_n; a++) {
+        for(auto b = 0; b < node_n; b++) {
+            if(a == b || common::get_random_in_range(1, 100) > edge_chance) continue;
+            auto edge = edge_t{ .tail = nodes[a], .head = nodes[b], .edge_data = {} };
+            if constexpr (std::is_convertible<E*, gr::DijkstraEdge*>::value) {
+                edge.edge_data.dijkstra_score = common::get_random_in_range(1, 100);
+            }
+            graph.edges.push_back(edge);
+            nodes[a]->edges.push_back(&graph.edges.back());
+            nodes[b]->edges.push_back(&graph.edges.back());
+        }
+    }
+    return graph;
+}
+
+void test_csr_layout() {
+    auto graph = random_graph<NodeData, EdgeData>(common::get_random_in_range(1, 40), 10);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto csr = gr::CSRGraph<>::from_graph(index);
+
+    assert(csr.vertex_count() == graph.nodes.size());
+    assert(csr.edge_count() == graph.edges.size());
+    for(gr::CSRGraph<>::vertex_t v = 0; v < csr.vertex_count(); v++) {
+        for(auto slot = csr.edge_begin(v); slot < csr.edge_end(v); slot++) {
+            auto* e = index.edges[csr.edge_ref(slot)];
+            assert(index.id(e->tail) == v && "slot stored under the wrong tail");
+            assert(index.id(e->head) == csr.head(slot) && "slot has the wrong head");
+            assert(e->edge_data.dijkstra_score == csr.weight(slot) && "slot has the wrong weight");
+        }
+    }
+    auto rev = csr.transpose();
+    assert(rev.edge_count() == csr.edge_count());
+    for(gr::CSRGraph<>::vertex_t v = 0; v < rev.vertex_count(); v++) {
+        for(auto slot = rev.edge_begin(v); slot < rev.edge_end(v); slot++) {
+            auto* e = index.edges[rev.edge_ref(slot)];
+            assert(index.id(e->head) == v && index.id(e->tail) == rev.head(slot) && "transpose did not flip the arc");
+        }
+    }
+}
+
+void test_csr_traversal_and_dijkstra() {
+    auto graph = random_graph<NodeData, EdgeData>(common::get_random_in_range(1, 40), 8);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto csr = gr::CSRGraph<>::from_graph(index);
+    auto start = common::get_random_in_range(0, graph.nodes.size() - 1);
+
+    for(auto& n : graph.nodes) n.node_data.explored = false;
+    gr::dfs<NodeData>(index.nodes[start]);
+    auto dfs_explored = gr::csr::dfs(csr, start);
+    auto bfs_explored = gr::csr::bfs(csr, start);
+    for(std::size_t v = 0; v < index.nodes.size(); v++) {
+        assert(index.nodes[v]->node_data.explored == dfs_explored[v] && "csr::dfs differs from gr::dfs");
+        assert(index.nodes[v]->node_data.explored == bfs_explored[v] && "csr::bfs differs from gr::dfs");
+    }
+
+    gr::dijkstra(graph, index.nodes[start]);
+    auto len = gr::csr::dijkstra(csr, start);
+    for(std::size_t v = 0; v < index.nodes.size(); v++) {
+        assert(index.nodes[v]->node_data.len == len[v] && "csr::dijkstra differs from gr::dijkstra");
+    }
+
+    auto end = common::get_random_in_range(0, graph.nodes.size() - 1);
+    auto path = gr::csr::dijkstra_shortest_path(csr, start, end);
+    if(len[end] == gr::CSRGraph<>::INF) {
+        assert(path.empty() && "path to an unreachable vertex");
+        return;
+    }
+    assert(path.front() == static_cast<std::size_t>(start) && path.back() == static_cast<std::size_t>(end));
+    std::size_t path_len = 0;
+    for(std::size_t i = 1; i < path.size(); i++) {
+        auto best = gr::CSRGraph<>::INF;
+        for(auto slot = csr.edge_begin(path[i - 1]); slot < csr.edge_end(path[i - 1]); slot++) {
+            if(csr.head(slot) == path[i]) best = std::min(best, csr.weight(slot));
+        }
+        assert(best != gr::CSRGraph<>::INF && "path uses a missing arc");
+        path_len += best;
+    }
+    assert(path_len == len[end] && "path is not a shortest one");
+}
+
+void test_csr_scc() {
+    auto graph = random_graph<SCCNodeData, gr::edge_empty_data>(common::get_random_in_range(1, 40), 4);
+    gr::GraphIndex<SCCNodeData> index{ graph };
+    auto csr = gr::CSRGraph<>::from_graph(index);
+
+    gr::strongly_connected(graph);
+    auto scc = gr::csr::strongly_connected(csr);
+    for(std::size_t a = 0; a < index.nodes.size(); a++) {
+        for(std::size_t b = 0; b < index.nodes.size(); b++) {
+            auto same = index.nodes[a]->node_data.scc_n == index.nodes[b]->node_data.scc_n;
+            assert(same == (scc[a] == scc[b]) && "csr::strongly_connected grouping differs");
+        }
+    }
+}
+
+void test_csr_mst() {
+    using graph_t = gr::Graph<NodeData, gr::DijkstraEdge>;
+    graph_t::vmatrix_e mtx = {{
+        //       a       b       c       d        e
+        { 0, { {0, 0}, {1, 1}, {1, 4}, {1, 3}, {0, 0} } },
+        { 1, { {1, 1}, {0, 0}, {0, 0}, {1, 2}, {0, 0} } },
+        { 2, { {1, 4}, {0, 0}, {0, 0}, {1, 5}, {1, 4} } },
+        { 3, { {1, 3}, {1, 2}, {1, 5}, {0, 0}, {1, 6} } },
+        { 4, { {0, 0}, {0, 0}, {1, 4}, {1, 6}, {0, 0} } },
+    }};
+    auto csr = gr::CSRGraph<>::from_matrix(mtx);
+    assert(csr.vertex_count() == 5 && csr.edge_count() == 14);
+
+    auto cost = [&](const std::vector<std::size_t>& tree) {
+        std::size_t sum = 0;
+        for(auto slot : tree) sum += csr.weight(slot);
+        return sum;
+    };
+    auto prim = gr::csr::prim_mst(csr, 0);
+    auto kruskal = gr::csr::kruskal_mst(csr);
+    assert(prim.size() == 4 && kruskal.size() == 4);
+    assert(cost(prim) == 11 && "csr::prim_mst is not minimal");
+    assert(cost(kruskal) == 11 && "csr::kruskal_mst is not minimal");
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_csr_layout();
+        test_csr_traversal_and_dijkstra();
+        test_csr_scc();
+    }
+    test_csr_mst();
+}
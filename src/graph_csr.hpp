@@ -0,0 +1,461 @@
+#ifndef GRAPH_CSR_HPP
+#define GRAPH_CSR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <datatypes.hpp>
+#include <graph.hpp>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gr {
+    /// weight of an edge as seen by the CSR algorithms,
+    /// DijkstraEdge scores are used as they are, any other edge weighs 1
+    template <typename E>
+    inline std::size_t edge_weight(const E& edge_data) {
+        if constexpr (std::is_convertible<const E*, const DijkstraEdge*>::value) {
+            return static_cast<const DijkstraEdge&>(edge_data).dijkstra_score;
+        } else {
+            return 1;
+        }
+    }
+
+    /// dense numbering of the nodes and edges of a gr::Graph (in list order),
+    /// used to translate between pointers and CSR vertex/edge ids
+    template <typename T, typename E = edge_empty_data>
+    class GraphIndex {
+    public:
+        using graph_t = Graph<T, E>;
+        using node_t = graph_t::node_t;
+        using edge_t = graph_t::edge_t;
+
+        std::vector<node_t*> nodes{};
+        std::vector<edge_t*> edges{};
+    private:
+        std::unordered_map<const node_t*, std::size_t> m_node_ids{};
+        std::unordered_map<const edge_t*, std::size_t> m_edge_ids{};
+    public:
+        GraphIndex() {}
+        explicit GraphIndex(Graph<T, E>& graph) {
+            nodes.reserve(graph.nodes.size());
+            edges.reserve(graph.edges.size());
+            m_node_ids.reserve(graph.nodes.size());
+            m_edge_ids.reserve(graph.edges.size());
+            for(auto& n : graph.nodes) {
+                m_node_ids.emplace(&n, nodes.size());
+                nodes.push_back(&n);
+            }
+            for(auto& e : graph.edges) {
+                m_edge_ids.emplace(&e, edges.size());
+                edges.push_back(&e);
+            }
+        }
+        inline std::size_t id(const node_t* node) const {
+            return m_node_ids.at(node);
+        }
+        inline std::size_t id(const edge_t* edge) const {
+            return m_edge_ids.at(edge);
+        }
+    };
+
+    /// immutable compressed sparse row graph, the out-arcs of vertex v occupy
+    /// the slots [offsets[v], offsets[v + 1]) of the target and weight arrays
+    template <typename W = std::size_t>
+    class CSRGraph {
+    public:
+        using vertex_t = std::uint32_t;
+        using weight_t = W;
+        /// (tail, head, weight)
+        using edge_tuple_t = std::tuple<vertex_t, vertex_t, W>;
+
+        inline static constexpr vertex_t NIL = std::numeric_limits<vertex_t>::max();
+        inline static constexpr W INF = std::numeric_limits<W>::max();
+    private:
+        std::vector<std::size_t> m_offsets{0};
+        std::vector<vertex_t> m_targets{};
+        std::vector<W> m_weights{};
+        /// id of the edge every slot was built from (index into the input)
+        std::vector<std::size_t> m_edge_refs{};
+
+        /// counting sort of the arcs by tail, keeps the input order within a vertex
+        inline static CSRGraph build(std::size_t n, const std::vector<edge_tuple_t>& arcs, const std::vector<std::size_t>* refs) {
+            if(n >= NIL) {
+                throw std::runtime_error("too many vertices for a CSR graph");
+            }
+            CSRGraph g{};
+            g.m_offsets.assign(n + 1, 0);
+            g.m_targets.resize(arcs.size());
+            g.m_weights.resize(arcs.size());
+            g.m_edge_refs.resize(arcs.size());
+
+            for(auto& [tail, head, w] : arcs) {
+                if(tail >= n || head >= n) {
+                    throw std::runtime_error("edge endpoint out of range");
+                }
+                g.m_offsets[tail + 1]++;
+            }
+            for(std::size_t v = 0; v < n; v++) {
+                g.m_offsets[v + 1] += g.m_offsets[v];
+            }
+            std::vector<std::size_t> cursor(g.m_offsets.begin(), g.m_offsets.end() - 1);
+            for(std::size_t i = 0; i < arcs.size(); i++) {
+                auto& [tail, head, w] = arcs[i];
+                auto slot = cursor[tail]++;
+                g.m_targets[slot] = head;
+                g.m_weights[slot] = w;
+                g.m_edge_refs[slot] = refs ? (*refs)[i] : i;
+            }
+            return g;
+        }
+    public:
+        CSRGraph() {}
+
+        inline std::size_t vertex_count() const {
+            return m_offsets.size() - 1;
+        }
+        inline std::size_t edge_count() const {
+            return m_targets.size();
+        }
+        inline std::size_t degree(vertex_t v) const {
+            return m_offsets[v + 1] - m_offsets[v];
+        }
+        /// first slot of v
+        inline std::size_t edge_begin(vertex_t v) const {
+            return m_offsets[v];
+        }
+        /// one past the last slot of v
+        inline std::size_t edge_end(vertex_t v) const {
+            return m_offsets[v + 1];
+        }
+        inline vertex_t head(std::size_t slot) const {
+            return m_targets[slot];
+        }
+        inline W weight(std::size_t slot) const {
+            return m_weights[slot];
+        }
+        inline std::size_t edge_ref(std::size_t slot) const {
+            return m_edge_refs[slot];
+        }
+        inline std::span<const vertex_t> neighbours(vertex_t v) const {
+            return { m_targets.data() + m_offsets[v], degree(v) };
+        }
+        inline std::span<const W> weights(vertex_t v) const {
+            return { m_weights.data() + m_offsets[v], degree(v) };
+        }
+        inline const std::vector<std::size_t>& offsets() const {
+            return m_offsets;
+        }
+        inline const std::vector<vertex_t>& targets() const {
+            return m_targets;
+        }
+        inline const std::vector<W>& weights() const {
+            return m_weights;
+        }
+
+        /// slot refs are the positions of the arcs in the input vector
+        inline static CSRGraph from_edges(std::size_t n, const std::vector<edge_tuple_t>& arcs) {
+            return build(n, arcs, nullptr);
+        }
+        inline static CSRGraph from_edges(std::size_t n, const std::vector<edge_tuple_t>& arcs, const std::vector<std::size_t>& refs) {
+            if(refs.size() != arcs.size()) {
+                throw std::runtime_error("every arc needs an edge ref");
+            }
+            return build(n, arcs, &refs);
+        }
+        /// only the edges a node lists with itself as the tail are its out-arcs,
+        /// slot refs are ids from the index
+        template <typename T, typename E>
+        inline static CSRGraph from_graph(const GraphIndex<T, E>& index) {
+            std::vector<edge_tuple_t> arcs{};
+            std::vector<std::size_t> refs{};
+            arcs.reserve(index.edges.size());
+            refs.reserve(index.edges.size());
+            for(std::size_t v = 0; v < index.nodes.size(); v++) {
+                auto* node = index.nodes[v];
+                for(auto* e : node->edges) {
+                    if(e->tail != node) continue;
+                    arcs.emplace_back(v, index.id(e->head), static_cast<W>(edge_weight(e->edge_data)));
+                    refs.push_back(index.id(e));
+                }
+            }
+            return build(index.nodes.size(), arcs, &refs);
+        }
+        template <typename T, typename E>
+        inline static CSRGraph from_graph(Graph<T, E>& graph) {
+            return from_graph(GraphIndex<T, E>(graph));
+        }
+        /// same input as Graph::from_matrix (vmatrix), every arc weighs 1
+        template <typename T>
+        inline static CSRGraph from_matrix(const std::vector<std::tuple<T, std::vector<int>>>& mtx) {
+            auto const N = mtx.size();
+            std::vector<edge_tuple_t> arcs{};
+            for(std::size_t a = 0; a < N; a++) {
+                auto& row = std::get<1>(mtx[a]);
+                if(row.size() != N) {
+                    throw std::runtime_error("the matrix must be a square matrix");
+                }
+                for(std::size_t b = 0; b < N; b++) {
+                    if(a == b) continue;
+                    if(row[b] == 1) {
+                        arcs.emplace_back(a, b, 1);
+                    }
+                }
+            }
+            return build(N, arcs, nullptr);
+        }
+        /// same input as Graph::from_matrix (vmatrix_e), the weight comes from the edge data
+        template <typename T, typename E>
+        inline static CSRGraph from_matrix(const std::vector<std::tuple<T, std::vector<std::tuple<int, E>>>>& mtx) {
+            auto const N = mtx.size();
+            std::vector<edge_tuple_t> arcs{};
+            for(std::size_t a = 0; a < N; a++) {
+                auto& row = std::get<1>(mtx[a]);
+                if(row.size() != N) {
+                    throw std::runtime_error("the matrix must be a square matrix");
+                }
+                for(std::size_t b = 0; b < N; b++) {
+                    if(a == b) continue;
+                    if(std::get<0>(row[b]) == 1) {
+                        arcs.emplace_back(a, b, static_cast<W>(edge_weight(std::get<1>(row[b]))));
+                    }
+                }
+            }
+            return build(N, arcs, nullptr);
+        }
+        /// graph with every arc reversed, slot refs are carried over
+        inline CSRGraph transpose() const {
+            std::vector<edge_tuple_t> arcs(edge_count());
+            std::vector<std::size_t> refs(edge_count());
+            for(vertex_t v = 0; v < vertex_count(); v++) {
+                for(auto slot = edge_begin(v); slot < edge_end(v); slot++) {
+                    arcs[slot] = { m_targets[slot], v, m_weights[slot] };
+                    refs[slot] = m_edge_refs[slot];
+                }
+            }
+            return build(vertex_count(), arcs, &refs);
+        }
+    };
+
+    /// algorithms over CSRGraph, vertices are dense ids and results are returned
+    /// in arrays indexed by them instead of being written into node data
+    namespace csr {
+        template <typename W>
+        inline std::vector<bool> dfs(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start) {
+            using vertex_t = CSRGraph<W>::vertex_t;
+            std::vector<bool> explored(g.vertex_count());
+            // (vertex, next slot to look at)
+            std::vector<std::pair<vertex_t, std::size_t>> stack{};
+            explored[start] = true;
+            stack.emplace_back(start, g.edge_begin(start));
+
+            while(!stack.empty()) {
+                auto& [v, slot] = stack.back();
+                if(slot == g.edge_end(v)) {
+                    stack.pop_back();
+                    continue;
+                }
+                auto w = g.head(slot++);
+                if(!explored[w]) {
+                    explored[w] = true;
+                    stack.emplace_back(w, g.edge_begin(w));
+                }
+            }
+            return explored;
+        }
+        template <typename W>
+        inline std::vector<bool> bfs(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start) {
+            using vertex_t = CSRGraph<W>::vertex_t;
+            std::vector<bool> explored(g.vertex_count());
+            std::vector<vertex_t> queue{};
+            queue.reserve(g.vertex_count());
+            queue.push_back(start);
+            explored[start] = true;
+
+            for(std::size_t i = 0; i < queue.size(); i++) {
+                for(auto w : g.neighbours(queue[i])) {
+                    if(!explored[w]) {
+                        explored[w] = true;
+                        queue.push_back(w);
+                    }
+                }
+            }
+            return explored;
+        }
+        namespace {
+            /// iterative dfs that appends every vertex to order once it is finished
+            template <typename W>
+            inline void dfs_finish_order(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start,
+                    std::vector<bool>& explored, std::vector<typename CSRGraph<W>::vertex_t>& order) {
+                using vertex_t = CSRGraph<W>::vertex_t;
+                std::vector<std::pair<vertex_t, std::size_t>> stack{};
+                explored[start] = true;
+                stack.emplace_back(start, g.edge_begin(start));
+
+                while(!stack.empty()) {
+                    auto& [v, slot] = stack.back();
+                    if(slot == g.edge_end(v)) {
+                        order.push_back(v);
+                        stack.pop_back();
+                        continue;
+                    }
+                    auto w = g.head(slot++);
+                    if(!explored[w]) {
+                        explored[w] = true;
+                        stack.emplace_back(w, g.edge_begin(w));
+                    }
+                }
+            }
+        }
+        /// Kosaraju's algorithm, returns the scc number of every vertex
+        template <typename W>
+        inline std::vector<std::size_t> strongly_connected(const CSRGraph<W>& g) {
+            using vertex_t = CSRGraph<W>::vertex_t;
+            constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+            auto const n = g.vertex_count();
+
+            auto rev = g.transpose();
+            std::vector<bool> explored(n);
+            std::vector<vertex_t> order{};
+            order.reserve(n);
+            for(vertex_t v = 0; v < n; v++) {
+                if(!explored[v]) {
+                    dfs_finish_order(rev, v, explored, order);
+                }
+            }
+
+            std::vector<std::size_t> scc(n, NONE);
+            std::vector<vertex_t> stack{};
+            std::size_t scc_n = 0;
+            for(auto it = order.rbegin(); it != order.rend(); it++) {
+                if(scc[*it] != NONE) continue;
+                scc[*it] = scc_n;
+                stack.push_back(*it);
+                while(!stack.empty()) {
+                    auto v = stack.back();
+                    stack.pop_back();
+                    for(auto w : g.neighbours(v)) {
+                        if(scc[w] == NONE) {
+                            scc[w] = scc_n;
+                            stack.push_back(w);
+                        }
+                    }
+                }
+                scc_n++;
+            }
+            return scc;
+        }
+        namespace {
+            template <typename W>
+            inline std::vector<W> dijkstra_impl(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start,
+                    typename CSRGraph<W>::vertex_t end, std::vector<typename CSRGraph<W>::vertex_t>* prev) {
+                using vertex_t = CSRGraph<W>::vertex_t;
+                constexpr auto INF = CSRGraph<W>::INF;
+
+                std::vector<W> len(g.vertex_count(), INF);
+                std::vector<bool> in_path(g.vertex_count());
+                if(prev) prev->assign(g.vertex_count(), CSRGraph<W>::NIL);
+                // only reached vertices go in, stale entries are skipped on extraction
+                dt::MinHeap<W, vertex_t> heap{};
+                len[start] = 0;
+                heap.insert(0, start);
+
+                while(!heap.empty()) {
+                    auto [k, w] = heap.extract();
+                    if(in_path[w]) continue;
+                    in_path[w] = true;
+                    if(w == end) break;
+                    for(auto slot = g.edge_begin(w); slot < g.edge_end(w); slot++) {
+                        auto h = g.head(slot);
+                        if(in_path[h]) continue;
+                        auto candidate = k + g.weight(slot);
+                        if(candidate < len[h]) {
+                            len[h] = candidate;
+                            if(prev) (*prev)[h] = w;
+                            heap.insert(candidate, h);
+                        }
+                    }
+                }
+                return len;
+            }
+        }
+        /// distance of every vertex from start, CSRGraph<W>::INF when unreachable
+        template <typename W>
+        inline std::vector<W> dijkstra(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start) {
+            return dijkstra_impl(g, start, CSRGraph<W>::NIL, nullptr);
+        }
+        /// vertices of a shortest path ordered from start to end, empty when end is unreachable
+        template <typename W>
+        inline std::vector<typename CSRGraph<W>::vertex_t> dijkstra_shortest_path(const CSRGraph<W>& g,
+                typename CSRGraph<W>::vertex_t start, typename CSRGraph<W>::vertex_t end) {
+            using vertex_t = CSRGraph<W>::vertex_t;
+            std::vector<vertex_t> prev{};
+            auto len = dijkstra_impl(g, start, end, &prev);
+            std::vector<vertex_t> path{};
+            if(len[end] == CSRGraph<W>::INF) return path;
+            for(auto v = end; v != CSRGraph<W>::NIL; v = prev[v]) {
+                path.push_back(v);
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+        /// Prim's algorithm grown from start, returns the slots of the tree edges.
+        /// Every vertex sits in an indexed heap at most once keyed by its
+        /// lightest arc from the tree, which is lowered in place
+        template <typename W>
+        inline std::vector<std::size_t> prim_mst(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start) {
+            constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+            std::vector<std::size_t> tree{};
+            std::vector<bool> explored(g.vertex_count());
+            std::vector<std::size_t> winner(g.vertex_count(), NONE);
+            dt::IndexedHeap<W> heap{ g.vertex_count() };
+
+            heap.push(start, W{});
+            while(!heap.empty()) {
+                auto [key, v] = heap.extract();
+                explored[v] = true;
+                if(winner[v] != NONE) tree.push_back(winner[v]);
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    auto h = g.head(slot);
+                    if(!explored[h] && heap.push_or_decrease(h, g.weight(slot))) {
+                        winner[h] = slot;
+                    }
+                }
+            }
+            return tree;
+        }
+        /// Kruskal's algorithm, returns the slots of the forest edges
+        template <typename W>
+        inline std::vector<std::size_t> kruskal_mst(const CSRGraph<W>& g) {
+            using vertex_t = CSRGraph<W>::vertex_t;
+            std::vector<std::size_t> slots(g.edge_count());
+            std::vector<vertex_t> tails(g.edge_count());
+            for(vertex_t v = 0; v < g.vertex_count(); v++) {
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    slots[slot] = slot;
+                    tails[slot] = v;
+                }
+            }
+            std::stable_sort(slots.begin(), slots.end(), [&](std::size_t a, std::size_t b) {
+                return g.weight(a) < g.weight(b);
+            });
+
+            std::vector<std::size_t> tree{};
+            dt::DisjointSets sets{ g.vertex_count() };
+            for(auto slot : slots) {
+                if(sets.unite(tails[slot], g.head(slot))) {
+                    tree.push_back(slot);
+                }
+            }
+            return tree;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_dag.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <random>
+#include <vector>
+
+struct TopoNodeData : public gr::TopoSortableGraphData {
+    TopoNodeData(){}
+};
+struct EdgeData : public gr::DijkstraEdge {
+    EdgeData(decltype(gr::DijkstraEdge::dijkstra_score) s) : gr::DijkstraEdge(s) {}
+    EdgeData() {}
+};
+struct NodeData : public gr::Graph<NodeData, EdgeData>::DijkstraData {
+    int id{};
+    NodeData(int n) : id(n) {}
+    NodeData(){}
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// random DAG whose arcs all go forward in a shuffled rank order
+csr_t random_dag(std::size_t n, std::size_t m, std::vector<vertex_t>& rank) {
+    rank.resize(n);
+    std::iota(rank.begin(), rank.end(), 0);
+    std::shuffle(rank.begin(), rank.end(), std::mt19937{std::random_device{}()});
+    std::vector<vertex_t> by_rank(n);
+    for(vertex_t v = 0; v < n; v++) by_rank[rank[v]] = v;
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(std::size_t i = 0; i < m && n > 1; i++) {
+        std::size_t a = common::get_random_in_range(0, n - 2);
+        std::size_t b = common::get_random_in_range(a + 1, n - 1);
+        arcs.emplace_back(by_rank[a], by_rank[b], 1);
+    }
+    return csr_t::from_edges(n, arcs);
+}
+
+void test_kahn_levels() {
+    std::size_t n = common::get_random_in_range(1, 2000);
+    std::vector<vertex_t> rank{};
+    auto g = random_dag(n, common::get_random_in_range(0, 3 * n), rank);
+
+    // longest path depth by dynamic programming over the known rank order
+    std::vector<vertex_t> by_rank(n);
+    for(vertex_t v = 0; v < n; v++) by_rank[rank[v]] = v;
+    std::vector<std::size_t> depth(n, 0);
+    for(auto v : by_rank) {
+        for(auto w : g.neighbours(v)) depth[w] = std::max(depth[w], depth[v] + 1);
+    }
+
+    for(std::size_t threads : { 1, 4 }) {
+        auto topo = gr::csr::kahn_topo_sort(g, threads);
+        assert(topo.is_dag() && topo.order.size() == n);
+        assert(topo.level == depth && "levels are not longest path depths");
+        std::vector<std::size_t> position(n);
+        for(std::size_t i = 0; i < n; i++) position[topo.order[i]] = i;
+        for(vertex_t v = 0; v < n; v++) {
+            for(auto w : g.neighbours(v)) {
+                assert(position[v] < position[w] && "arc goes backwards in the order");
+            }
+        }
+        for(std::size_t l = 0; l < topo.level_count(); l++) {
+            for(auto i = topo.level_begin[l]; i < topo.level_begin[l + 1]; i++) {
+                assert(topo.level[topo.order[i]] == l && "vertex listed in the wrong level");
+            }
+        }
+    }
+}
+
+void test_kahn_cycle_witness() {
+    std::size_t n = common::get_random_in_range(2, 500);
+    std::vector<vertex_t> rank{};
+    auto dag = random_dag(n, common::get_random_in_range(1, 3 * n), rank);
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(vertex_t v = 0; v < n; v++) {
+        for(auto w : dag.neighbours(v)) arcs.emplace_back(v, w, 1);
+    }
+    // a backward arc closes a cycle whenever its endpoints are connected
+    auto [tail, head, w] = arcs[common::get_random_in_range(0, arcs.size() - 1)];
+    arcs.emplace_back(head, tail, 1);
+    auto g = csr_t::from_edges(n, arcs);
+
+    auto topo = gr::csr::kahn_topo_sort(g, 2);
+    assert(!topo.is_dag() && topo.order.size() < n);
+    for(std::size_t i = 0; i < topo.cycle.size(); i++) {
+        auto a = topo.cycle[i], b = topo.cycle[(i + 1) % topo.cycle.size()];
+        auto neighbours = g.neighbours(a);
+        assert(std::find(neighbours.begin(), neighbours.end(), b) != neighbours.end() && "cycle follows a missing arc");
+        assert(topo.level[a] == gr::csr::TopoOrder::NO_LEVEL);
+    }
+}
+
+void test_graph_kahn_topo_sort() {
+    using graph_t = gr::Graph<TopoNodeData>;
+    std::size_t n = common::get_random_in_range(1, 100);
+    std::vector<vertex_t> rank{};
+    auto dag = random_dag(n, common::get_random_in_range(0, 3 * n), rank);
+    graph_t graph{};
+    std::vector<graph_t::node_t*> nodes(n);
+    for(auto& node : nodes) {
+        graph.nodes.push_back({ .edges = {}, .node_data = {} });
+        node = &graph.nodes.back();
+    }
+    for(vertex_t v = 0; v < n; v++) {
+        for(auto w : dag.neighbours(v)) {
+            graph.edges.push_back({ .tail = nodes[v], .head = nodes[w], .edge_data = {} });
+            nodes[v]->edges.push_back(&graph.edges.back());
+            nodes[w]->edges.push_back(&graph.edges.back());
+        }
+    }
+    auto topo = gr::kahn_topo_sort(graph);
+    assert(topo.is_dag() && topo.order.size() == n && topo.level.size() == n);
+    for(auto& e : graph.edges) {
+        assert(e.tail->node_data.f_value < e.head->node_data.f_value && "f_value does not follow the arcs");
+    }
+    for(std::size_t i = 1; i < n; i++) {
+        assert(topo.level[i - 1] <= topo.level[i] && "order is not grouped by level");
+    }
+}
+
+void test_dynamic_topo_order() {
+    using graph_t = gr::Graph<TopoNodeData>;
+    using node_t = graph_t::node_t;
+    graph_t graph{};
+    std::vector<node_t*> nodes{};
+    for(auto i = common::get_random_in_range(1, 30); i > 0; i--) {
+        graph.nodes.push_back({ .edges = {}, .node_data = {} });
+        nodes.push_back(&graph.nodes.back());
+    }
+    gr::DynamicTopoOrder<TopoNodeData> topo{ graph };
+
+    // does from reach to over the out-arcs in the graph
+    auto reaches = [](node_t* from, node_t* to) {
+        std::vector<node_t*> stack{ from };
+        std::vector<node_t*> seen{ from };
+        while(!stack.empty()) {
+            auto* v = stack.back();
+            stack.pop_back();
+            if(v == to) return true;
+            for(auto* e : v->edges) {
+                if(e->tail != v || std::find(seen.begin(), seen.end(), e->head) != seen.end()) continue;
+                seen.push_back(e->head);
+                stack.push_back(e->head);
+            }
+        }
+        return false;
+    };
+    for(auto step = 0; step < 300; step++) {
+        if(common::get_random_in_range(1, 100) <= 5) {
+            nodes.push_back(topo.insert_node());
+            continue;
+        }
+        auto* tail = nodes[common::get_random_in_range(0, nodes.size() - 1)];
+        auto* head = nodes[common::get_random_in_range(0, nodes.size() - 1)];
+        auto edges_before = graph.edges.size();
+        auto would_cycle = tail == head || reaches(head, tail);
+        auto* edge = topo.insert_edge(tail, head);
+        assert((edge == nullptr) == would_cycle && "insert_edge accepted a cycle or rejected a DAG edge");
+        assert(graph.edges.size() == edges_before + (edge ? 1 : 0));
+
+        assert(topo.order().size() == graph.nodes.size());
+        for(std::size_t i = 0; i < topo.order().size(); i++) {
+            assert(topo.position(topo.order()[i]) == i && topo.order()[i]->node_data.f_value == i);
+        }
+        for(auto& e : graph.edges) {
+            assert(topo.position(e.tail) < topo.position(e.head) && "order broken by an insertion");
+        }
+    }
+
+    // a cyclic graph cannot be ordered at all
+    graph_t cyclic{};
+    cyclic.nodes.push_back({ .edges = {}, .node_data = {} });
+    cyclic.nodes.push_back({ .edges = {}, .node_data = {} });
+    auto* a = &cyclic.nodes.front();
+    auto* b = &cyclic.nodes.back();
+    cyclic.edges.push_back({ .tail = a, .head = b, .edge_data = {} });
+    cyclic.edges.push_back({ .tail = b, .head = a, .edge_data = {} });
+    for(auto& e : cyclic.edges) {
+        e.tail->edges.push_back(&e);
+        e.head->edges.push_back(&e);
+    }
+    bool thrown = false;
+    try {
+        gr::DynamicTopoOrder<TopoNodeData> broken{ cyclic };
+    } catch(const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "DynamicTopoOrder accepted a cyclic graph");
+}
+
+/// the arcs of dag with random weights in [lo, hi]
+template <typename W>
+gr::CSRGraph<W> reweight(const csr_t& dag, int lo, int hi) {
+    std::vector<typename gr::CSRGraph<W>::edge_tuple_t> arcs{};
+    for(vertex_t v = 0; v < dag.vertex_count(); v++) {
+        for(auto w : dag.neighbours(v)) {
+            arcs.emplace_back(v, w, static_cast<W>(common::get_random_in_range(lo, hi)));
+        }
+    }
+    return gr::CSRGraph<W>::from_edges(dag.vertex_count(), arcs);
+}
+
+void test_dag_shortest_paths() {
+    std::size_t n = common::get_random_in_range(1, 1000);
+    std::vector<vertex_t> rank{};
+    auto g = reweight<std::size_t>(random_dag(n, common::get_random_in_range(0, 3 * n), rank), 0, 100);
+    vertex_t s = common::get_random_in_range(0, n - 1);
+    auto paths = gr::csr::dag_shortest_paths(g, s);
+    assert(paths.len == gr::csr::dijkstra(g, s) && "dag_shortest_paths differs from csr::dijkstra");
+    for(vertex_t v = 0; v < n; v++) {
+        std::size_t len = 0;
+        auto at = s;
+        for(auto slot : paths.path_slots(v)) {
+            assert(at == paths.parent[g.head(slot)] && "parent slots do not form a walk");
+            len += g.weight(slot);
+            at = g.head(slot);
+        }
+        assert((paths.len[v] == csr_t::INF || (at == v && len == paths.len[v])) && "path has the wrong length");
+    }
+}
+
+void test_dag_longest_and_critical_path() {
+    using signed_t = gr::CSRGraph<long>;
+    std::size_t n = common::get_random_in_range(1, 1000);
+    std::vector<vertex_t> rank{};
+    auto g = reweight<long>(random_dag(n, common::get_random_in_range(0, 3 * n), rank), -20, 100);
+    std::vector<vertex_t> by_rank(n);
+    for(vertex_t v = 0; v < n; v++) by_rank[rank[v]] = v;
+
+    // both directions by dynamic programming over the known rank order
+    vertex_t s = common::get_random_in_range(0, n - 1);
+    std::vector<long> shortest(n, signed_t::INF), longest(n, signed_t::INF);
+    shortest[s] = longest[s] = 0;
+    for(auto v : by_rank) {
+        if(shortest[v] == signed_t::INF) continue;
+        for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+            auto h = g.head(slot);
+            auto lo = shortest[v] + g.weight(slot), hi = longest[v] + g.weight(slot);
+            if(shortest[h] == signed_t::INF || lo < shortest[h]) shortest[h] = lo;
+            if(longest[h] == signed_t::INF || hi > longest[h]) longest[h] = hi;
+        }
+    }
+    auto topo = gr::csr::kahn_topo_sort(g);
+    assert(gr::csr::dag_shortest_paths(g, s, topo).len == shortest && "negative arcs broke dag_shortest_paths");
+    assert(gr::csr::dag_longest_paths(g, s, topo).len == longest && "dag_longest_paths is not the heaviest path");
+
+    auto cp = gr::csr::critical_path(g, topo);
+    long length = 0;
+    for(auto v : by_rank) {
+        length = std::max(length, cp.earliest[v]);
+        assert(cp.earliest[v] >= 0 && cp.latest[v] <= cp.length);
+        assert(cp.slack[v] >= 0 && cp.latest[v] - cp.earliest[v] == cp.slack[v]);
+        for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+            assert(cp.earliest[v] + g.weight(slot) <= cp.earliest[g.head(slot)] && "earliest start too early");
+            assert(cp.latest[v] + g.weight(slot) <= cp.latest[g.head(slot)] && "latest start too late");
+            assert(cp.arc_slack[slot] >= 0);
+        }
+    }
+    assert(cp.length == length);
+    long walked = 0;
+    for(std::size_t i = 0; i < cp.path.size(); i++) {
+        auto slot = cp.path[i];
+        assert(cp.arc_slack[slot] == 0 && "critical path arc has slack");
+        walked += g.weight(slot);
+        if(i + 1 < cp.path.size()) {
+            auto next = cp.path[i + 1];
+            assert(next >= g.edge_begin(g.head(slot)) && next < g.edge_end(g.head(slot)) && "critical path is not a walk");
+        }
+    }
+    assert(walked == cp.length && "critical path is not as long as the schedule");
+}
+
+void test_dag_paths_reject_cycles() {
+    auto g = csr_t::from_edges(3, { { 0, 1, 1 }, { 1, 2, 1 }, { 2, 1, 1 } });
+    bool thrown = false;
+    try {
+        gr::csr::dag_longest_paths(g, 0);
+    } catch(const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "dag_longest_paths accepted a cyclic graph");
+}
+
+void test_graph_dag_shortest_paths() {
+    using graph_t = gr::Graph<NodeData, EdgeData>;
+    graph_t::vmatrix_e mtx = {{
+        //       a       b       c       d       e       f
+        { 0, { {0, 0}, {1, 7}, {1, 9}, {0, 0}, {0, 0}, {1, 14} } },
+        { 1, { {0, 0}, {0, 0}, {1, 10}, {1, 15}, {0, 0}, {0, 0} } },
+        { 2, { {0, 0}, {0, 0}, {0, 0}, {1, 11}, {0, 0}, {1, 2} } },
+        { 3, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 6}, {0, 0} } },
+        { 4, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0} } },
+        { 5, { {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 9}, {0, 0} } },
+    }};
+    auto expected = graph_t::from_matrix(mtx);
+    auto graph = graph_t::from_matrix(mtx);
+    gr::dijkstra(expected, &expected.nodes.front());
+    gr::dag_shortest_paths(graph, &graph.nodes.front());
+    for(auto a = expected.nodes.begin(), b = graph.nodes.begin(); a != expected.nodes.end(); a++, b++) {
+        assert(a->node_data.len == b->node_data.len && "dag_shortest_paths differs from gr::dijkstra");
+    }
+    for(auto a = expected.nodes.begin(), b = graph.nodes.begin(); a != expected.nodes.end(); a++, b++) {
+        // the shortest paths of this graph are unique, prev must follow them
+        auto path = gr::dijkstra_shortest_path(expected, &expected.nodes.front(), &*a);
+        auto* v = &*b;
+        for(auto* node : path) {
+            assert(v && v->node_data.id == node->node_data.id && "prev does not follow the shortest path");
+            v = v->node_data.prev;
+        }
+        assert(v == nullptr);
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_kahn_levels();
+        test_kahn_cycle_witness();
+        test_graph_kahn_topo_sort();
+        test_dynamic_topo_order();
+        test_dag_shortest_paths();
+        test_dag_longest_and_critical_path();
+    }
+    test_dag_paths_reject_cycles();
+    test_graph_dag_shortest_paths();
+}
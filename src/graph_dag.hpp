@@ -0,0 +1,434 @@
+#ifndef GRAPH_DAG_HPP
+#define GRAPH_DAG_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    /// topological order grouped into levels, level 0 holds the sources and
+    /// every other vertex sits one level below its deepest predecessor
+    struct TopoOrder {
+        using vertex_t = CSRGraph<>::vertex_t;
+        inline static constexpr std::size_t NO_LEVEL = std::numeric_limits<std::size_t>::max();
+
+        /// all vertices when the graph is a DAG, level by level
+        std::vector<vertex_t> order{};
+        /// level of every vertex (longest path depth), NO_LEVEL for vertices on or behind a cycle
+        std::vector<std::size_t> level{};
+        /// order[level_begin[l] .. level_begin[l + 1]) is level l
+        std::vector<std::size_t> level_begin{};
+        /// vertices of one cycle in arc order, empty for a DAG
+        std::vector<vertex_t> cycle{};
+
+        inline bool is_dag() const {
+            return cycle.empty();
+        }
+        inline std::size_t level_count() const {
+            return level_begin.empty() ? 0 : level_begin.size() - 1;
+        }
+    };
+
+    /// Kahn's algorithm one level at a time. The vertices of a level are
+    /// independent, so the level is split between the workers and each arc
+    /// decrements the in-degree of its head atomically, whoever brings it to
+    /// zero puts the head in the next level. Vertices inside a level keep no
+    /// particular order when threads > 1.
+    /// A cycle leaves vertices behind, one cycle among them is reported
+    template <typename W>
+    inline TopoOrder kahn_topo_sort(const CSRGraph<W>& g, std::size_t threads = 1) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        auto const n = g.vertex_count();
+        threads = worker_count(threads);
+
+        TopoOrder topo{};
+        topo.level.assign(n, TopoOrder::NO_LEVEL);
+        topo.order.reserve(n);
+        std::vector<std::atomic<std::size_t>> in_deg(n);
+        for(vertex_t v = 0; v < n; v++) {
+            for(auto w : g.neighbours(v)) in_deg[w].fetch_add(1, std::memory_order_relaxed);
+        }
+        std::vector<vertex_t> frontier{};
+        for(vertex_t v = 0; v < n; v++) {
+            if(in_deg[v].load(std::memory_order_relaxed) == 0) frontier.push_back(v);
+        }
+
+        for(std::size_t l = 0; !frontier.empty(); l++) {
+            topo.level_begin.push_back(topo.order.size());
+            for(auto v : frontier) topo.level[v] = l;
+            topo.order.insert(topo.order.end(), frontier.begin(), frontier.end());
+            frontier = expand_frontier(frontier, threads, [&](vertex_t v, std::vector<vertex_t>& out) {
+                for(auto w : g.neighbours(v)) {
+                    if(in_deg[w].fetch_sub(1, std::memory_order_relaxed) == 1) out.push_back(w);
+                }
+            });
+        }
+        topo.level_begin.push_back(topo.order.size());
+        if(topo.order.size() == n) return topo;
+
+        // every vertex left has a predecessor that is left too, walking
+        // backwards from any of them has to run into a cycle
+        auto rev = g.transpose();
+        std::vector<std::size_t> seen_at(n, TopoOrder::NO_LEVEL);
+        std::vector<vertex_t> walk{};
+        auto v = static_cast<vertex_t>(std::find(topo.level.begin(), topo.level.end(), TopoOrder::NO_LEVEL) - topo.level.begin());
+        while(seen_at[v] == TopoOrder::NO_LEVEL) {
+            seen_at[v] = walk.size();
+            walk.push_back(v);
+            for(auto u : rev.neighbours(v)) {
+                if(topo.level[u] == TopoOrder::NO_LEVEL) {
+                    v = u;
+                    break;
+                }
+            }
+        }
+        topo.cycle.assign(walk.begin() + seen_at[v], walk.end());
+        std::reverse(topo.cycle.begin(), topo.cycle.end());
+        return topo;
+    }
+
+    /// single source result of dag_shortest_paths / dag_longest_paths,
+    /// len is INF and parent NIL for vertices the source does not reach
+    template <typename W>
+    struct DagPaths {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr std::size_t NO_SLOT = std::numeric_limits<std::size_t>::max();
+
+        std::vector<W> len{};
+        std::vector<vertex_t> parent{};
+        std::vector<std::size_t> parent_slot{};
+
+        /// arc slots from the source to target, empty when it is not reached
+        inline std::vector<std::size_t> path_slots(vertex_t target) const {
+            std::vector<std::size_t> slots{};
+            if(len[target] == CSRGraph<W>::INF) return slots;
+            for(auto v = target; parent[v] != CSRGraph<W>::NIL; v = parent[v]) {
+                slots.push_back(parent_slot[v]);
+            }
+            std::reverse(slots.begin(), slots.end());
+            return slots;
+        }
+    };
+
+    namespace {
+        inline void require_dag(const TopoOrder& topo) {
+            if(!topo.is_dag()) {
+                throw std::runtime_error("the graph has a cycle");
+            }
+        }
+        /// one pass over the order relaxing every out-arc of a reached vertex,
+        /// better(a, b) picks shorter or longer paths
+        template <typename W, typename Better>
+        inline DagPaths<W> dag_paths(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source,
+                const TopoOrder& topo, Better&& better) {
+            require_dag(topo);
+            constexpr auto INF = CSRGraph<W>::INF;
+            auto const n = g.vertex_count();
+            DagPaths<W> paths{};
+            paths.len.assign(n, INF);
+            paths.parent.assign(n, CSRGraph<W>::NIL);
+            paths.parent_slot.assign(n, DagPaths<W>::NO_SLOT);
+            paths.len[source] = 0;
+            for(auto v : topo.order) {
+                if(paths.len[v] == INF) continue;
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    auto h = g.head(slot);
+                    auto candidate = paths.len[v] + g.weight(slot);
+                    if(paths.len[h] == INF || better(candidate, paths.len[h])) {
+                        paths.len[h] = candidate;
+                        paths.parent[h] = v;
+                        paths.parent_slot[h] = slot;
+                    }
+                }
+            }
+            return paths;
+        }
+    }
+
+    /// shortest paths from source in O(V+E), negative arcs are fine.
+    /// topo must be kahn_topo_sort(g), throws when g has a cycle
+    template <typename W>
+    inline DagPaths<W> dag_shortest_paths(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source, const TopoOrder& topo) {
+        return dag_paths(g, source, topo, [](W a, W b) { return a < b; });
+    }
+    template <typename W>
+    inline DagPaths<W> dag_shortest_paths(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source) {
+        return dag_shortest_paths(g, source, kahn_topo_sort(g));
+    }
+    /// longest (heaviest) paths from source in O(V+E)
+    template <typename W>
+    inline DagPaths<W> dag_longest_paths(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source, const TopoOrder& topo) {
+        return dag_paths(g, source, topo, [](W a, W b) { return b < a; });
+    }
+    template <typename W>
+    inline DagPaths<W> dag_longest_paths(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source) {
+        return dag_longest_paths(g, source, kahn_topo_sort(g));
+    }
+
+    /// critical path method with arcs as activities and their weight as the
+    /// duration, vertices are events. earliest is the longest path from any
+    /// source, latest the last time an event can happen without delaying
+    /// the whole schedule, their difference the slack. The schedule starts at
+    /// 0, so with negative arcs both are kept within [0, length]
+    template <typename W>
+    struct CriticalPath {
+        W length{};
+        std::vector<W> earliest{};
+        std::vector<W> latest{};
+        std::vector<W> slack{};
+        /// by slot, how much that activity can be delayed
+        std::vector<W> arc_slack{};
+        /// slots of one longest path, every arc on it has no slack
+        std::vector<std::size_t> path{};
+    };
+
+    template <typename W>
+    inline CriticalPath<W> critical_path(const CSRGraph<W>& g, const TopoOrder& topo) {
+        require_dag(topo);
+        using vertex_t = CSRGraph<W>::vertex_t;
+        auto const n = g.vertex_count();
+        CriticalPath<W> cp{};
+        cp.earliest.assign(n, 0);
+        std::vector<std::size_t> via(n, DagPaths<W>::NO_SLOT);
+        std::vector<vertex_t> from(n, CSRGraph<W>::NIL);
+        for(auto v : topo.order) {
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                auto h = g.head(slot);
+                auto candidate = cp.earliest[v] + g.weight(slot);
+                if(cp.earliest[h] < candidate) {
+                    cp.earliest[h] = candidate;
+                    from[h] = v;
+                    via[h] = slot;
+                }
+            }
+        }
+        vertex_t end = CSRGraph<W>::NIL;
+        for(vertex_t v = 0; v < n; v++) {
+            if(end == CSRGraph<W>::NIL || cp.earliest[end] < cp.earliest[v]) end = v;
+        }
+        cp.length = n ? cp.earliest[end] : 0;
+
+        cp.latest.assign(n, cp.length);
+        for(auto it = topo.order.rbegin(); it != topo.order.rend(); it++) {
+            auto v = *it;
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                cp.latest[v] = std::min(cp.latest[v], cp.latest[g.head(slot)] - g.weight(slot));
+            }
+        }
+        cp.slack.resize(n);
+        cp.arc_slack.resize(g.edge_count());
+        for(vertex_t v = 0; v < n; v++) {
+            cp.slack[v] = cp.latest[v] - cp.earliest[v];
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                cp.arc_slack[slot] = cp.latest[g.head(slot)] - cp.earliest[v] - g.weight(slot);
+            }
+        }
+        for(auto v = end; n && from[v] != CSRGraph<W>::NIL; v = from[v]) {
+            cp.path.push_back(via[v]);
+        }
+        std::reverse(cp.path.begin(), cp.path.end());
+        return cp;
+    }
+    template <typename W>
+    inline CriticalPath<W> critical_path(const CSRGraph<W>& g) {
+        return critical_path(g, kahn_topo_sort(g));
+    }
+}
+
+namespace gr {
+    /// kahn_topo_sort for a gr::Graph, order[i] sits on level[i]
+    template <typename N>
+    struct GraphTopoOrder {
+        std::vector<N*> order{};
+        std::vector<std::size_t> level{};
+        std::vector<std::size_t> level_begin{};
+        std::vector<N*> cycle{};
+
+        inline bool is_dag() const {
+            return cycle.empty();
+        }
+    };
+
+    /// iterative replacement for topo_sort that also reports levels and
+    /// cycles. When T derives from TopoSortableGraphData f_value is set to
+    /// the position in the order like topo_sort does (left alone on a cycle)
+    template <typename T, typename E, typename N = Graph<T, E>::node_t>
+    inline GraphTopoOrder<N> kahn_topo_sort(Graph<T, E>& graph, std::size_t threads = 1) {
+        GraphIndex<T, E> index{ graph };
+        auto topo = csr::kahn_topo_sort(CSRGraph<>::from_graph(index), threads);
+
+        GraphTopoOrder<N> result{};
+        result.level_begin = std::move(topo.level_begin);
+        for(auto v : topo.order) {
+            result.order.push_back(index.nodes[v]);
+            result.level.push_back(topo.level[v]);
+        }
+        for(auto v : topo.cycle) {
+            result.cycle.push_back(index.nodes[v]);
+        }
+        if constexpr (std::is_convertible<T*, TopoSortableGraphData*>::value) {
+            if(result.is_dag()) {
+                for(std::size_t i = 0; i < result.order.size(); i++) {
+                    static_cast<TopoSortableGraphData*>(&result.order[i]->node_data)->f_value = i;
+                }
+            }
+        }
+        return result;
+    }
+
+    /// dijkstra_h for DAGs: one pass over a topological order, no heap, and
+    /// the same len / prev output in the node data. Throws when the graph has a cycle
+    template <typename T, typename E, typename N = Graph<T, E>::node_t, typename DData = Graph<T, E>::dijkstra_data_t>
+    inline void dag_shortest_paths(Graph<T, E>& graph, N* start) {
+        static_assert(std::is_convertible<T*, DData*>::value, "T must be derived from DijkstraData");
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from DijkstraEdge");
+        GraphIndex<T, E> index{ graph };
+        auto g = CSRGraph<>::from_graph(index);
+        auto paths = csr::dag_shortest_paths(g, static_cast<CSRGraph<>::vertex_t>(index.id(start)));
+        for(std::size_t v = 0; v < index.nodes.size(); v++) {
+            auto* data = static_cast<DData*>(&index.nodes[v]->node_data);
+            data->len = paths.len[v];
+            data->prev = paths.parent[v] == CSRGraph<>::NIL ? nullptr : index.nodes[paths.parent[v]];
+        }
+    }
+
+    /// topological order of a gr::Graph kept up to date while edges come in
+    /// (Pearce and Kelly). Inserting tail -> head when tail already comes
+    /// first costs nothing, otherwise only the nodes between the two positions
+    /// that head reaches or that reach tail are searched and then shuffled
+    /// among their own positions. An edge that would close a cycle is found by
+    /// the same search and is not inserted. Edges must be added through
+    /// insert_edge and nodes through insert_node to keep the order valid.
+    /// When T derives from TopoSortableGraphData f_value follows the position
+    template <typename T, typename E = edge_empty_data>
+    class DynamicTopoOrder {
+    public:
+        using graph_t = Graph<T, E>;
+        using node_t = graph_t::node_t;
+        using edge_t = graph_t::edge_t;
+    private:
+        graph_t* m_graph;
+        std::vector<node_t*> m_node_at{};
+        std::unordered_map<const node_t*, std::size_t> m_position{};
+        /// by position, only set during a search
+        std::vector<bool> m_visited{};
+        std::vector<node_t*> m_forward{};
+        std::vector<node_t*> m_backward{};
+        std::vector<node_t*> m_stack{};
+
+        inline void place(node_t* v, std::size_t at) {
+            m_node_at[at] = v;
+            m_position[v] = at;
+            if constexpr (std::is_convertible<T*, TopoSortableGraphData*>::value) {
+                static_cast<TopoSortableGraphData*>(&v->node_data)->f_value = at;
+            }
+        }
+        /// dfs from start collecting unvisited nodes whose position passes
+        /// keep, false if it ran into stop
+        template <typename Step, typename Keep>
+        inline bool search(node_t* start, node_t* stop, std::vector<node_t*>& found, Step&& step, Keep&& keep) {
+            m_stack.assign(1, start);
+            m_visited[m_position[start]] = true;
+            found.push_back(start);
+            while(!m_stack.empty()) {
+                auto* v = m_stack.back();
+                m_stack.pop_back();
+                for(auto* e : v->edges) {
+                    auto* w = step(v, e);
+                    if(!w) continue;
+                    if(w == stop) return false;
+                    auto at = m_position[w];
+                    if(m_visited[at] || !keep(at)) continue;
+                    m_visited[at] = true;
+                    found.push_back(w);
+                    m_stack.push_back(w);
+                }
+            }
+            return true;
+        }
+    public:
+        /// orders the graph as it is, throws when it already has a cycle
+        explicit DynamicTopoOrder(graph_t& graph) : m_graph(&graph) {
+            auto topo = kahn_topo_sort(graph);
+            if(!topo.is_dag()) {
+                throw std::runtime_error("the graph has a cycle");
+            }
+            m_node_at.resize(topo.order.size());
+            m_visited.assign(topo.order.size(), false);
+            for(std::size_t i = 0; i < topo.order.size(); i++) {
+                place(topo.order[i], i);
+            }
+        }
+
+        inline const std::vector<node_t*>& order() const {
+            return m_node_at;
+        }
+        inline std::size_t position(const node_t* v) const {
+            return m_position.at(v);
+        }
+        /// adds a node to the graph, placed after every other node
+        inline node_t* insert_node(T data = {}) {
+            m_graph->nodes.push_back(node_t{ .edges = {}, .node_data = std::move(data) });
+            auto* v = &m_graph->nodes.back();
+            m_node_at.push_back(nullptr);
+            m_visited.push_back(false);
+            place(v, m_node_at.size() - 1);
+            return v;
+        }
+        /// adds tail -> head to the graph (listed by both endpoints) and
+        /// repairs the order, nullptr and no change when it would close a cycle
+        inline edge_t* insert_edge(node_t* tail, node_t* head, E data = {}) {
+            if(tail == head) return nullptr;
+            auto lower = m_position.at(head), upper = m_position.at(tail);
+            if(upper < lower) {
+                m_graph->edges.push_back(edge_t{ .tail = tail, .head = head, .edge_data = std::move(data) });
+                tail->edges.push_back(&m_graph->edges.back());
+                head->edges.push_back(&m_graph->edges.back());
+                return &m_graph->edges.back();
+            }
+
+            m_forward.clear();
+            m_backward.clear();
+            auto out_arc = [](node_t* v, edge_t* e) { return e->tail == v ? e->head : nullptr; };
+            auto in_arc = [](node_t* v, edge_t* e) { return e->head == v ? e->tail : nullptr; };
+            // the new edge is fine unless head already reaches tail
+            bool acyclic = search(head, tail, m_forward, out_arc, [&](std::size_t at) { return at < upper; });
+            if(acyclic) {
+                search(tail, nullptr, m_backward, in_arc, [&](std::size_t at) { return at > lower; });
+            }
+            for(auto* v : m_forward) m_visited[m_position[v]] = false;
+            for(auto* v : m_backward) m_visited[m_position[v]] = false;
+            if(!acyclic) return nullptr;
+
+            // everything that reaches tail goes before everything head reaches,
+            // both keep their relative order and reuse the same positions
+            auto by_position = [&](node_t* a, node_t* b) { return m_position[a] < m_position[b]; };
+            std::sort(m_forward.begin(), m_forward.end(), by_position);
+            std::sort(m_backward.begin(), m_backward.end(), by_position);
+            std::vector<std::size_t> slots{};
+            slots.reserve(m_forward.size() + m_backward.size());
+            for(auto* v : m_backward) slots.push_back(m_position[v]);
+            for(auto* v : m_forward) slots.push_back(m_position[v]);
+            std::sort(slots.begin(), slots.end());
+            std::size_t i = 0;
+            for(auto* v : m_backward) place(v, slots[i++]);
+            for(auto* v : m_forward) place(v, slots[i++]);
+
+            m_graph->edges.push_back(edge_t{ .tail = tail, .head = head, .edge_data = std::move(data) });
+            tail->edges.push_back(&m_graph->edges.back());
+            head->edges.push_back(&m_graph->edges.back());
+            return &m_graph->edges.back();
+        }
+    };
+}
+
+#endif
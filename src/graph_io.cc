@@ -0,0 +1,131 @@
+#include <common.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_io.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct NodeData : public gr::ExplorableGraphData {
+    NodeData(){}
+};
+
+using edge_tuple_t = gr::io::EdgeList<>::edge_tuple_t;
+
+/// random edge list in the requested format together with the arcs it describes
+std::tuple<std::string, std::vector<edge_tuple_t>, std::size_t> random_edge_list(gr::io::Format format) {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto m = common::get_random_in_range(0, 2000);
+    std::vector<edge_tuple_t> arcs{};
+    std::string text{};
+    if(format == gr::io::Format::dimacs) {
+        text += "c random graph\n";
+        text += "p sp " + std::to_string(n) + " " + std::to_string(m) + "\n";
+    } else {
+        text += "# random graph\n";
+    }
+    for(auto i = 0; i < m; i++) {
+        gr::io::EdgeList<>::vertex_t u = common::get_random_in_range(0, n - 1);
+        gr::io::EdgeList<>::vertex_t v = common::get_random_in_range(0, n - 1);
+        std::size_t w = common::get_random_in_range(0, 1000);
+        arcs.emplace_back(u, v, w);
+        if(format == gr::io::Format::dimacs) {
+            text += "a " + std::to_string(u + 1) + " " + std::to_string(v + 1) + " " + std::to_string(w) + "\n";
+        } else {
+            text += std::to_string(u) + "\t" + std::to_string(v) + " " + std::to_string(w) + (i % 7 ? "\n" : "\r\n");
+        }
+        if(i % 50 == 0) text += "\n";
+    }
+    if(format == gr::io::Format::plain) {
+        // the plain format has no header, the vertex count is the largest id + 1
+        n = 0;
+        for(auto& [u, v, w] : arcs) n = std::max<std::size_t>({ n, u + 1ul, v + 1ul });
+    }
+    return { text, arcs, n };
+}
+
+void test_parse(gr::io::Format format) {
+    auto [text, arcs, n] = random_edge_list(format);
+    for(std::size_t threads : { 1, 3, 8 }) {
+        auto list = gr::io::parse_edge_list(text, { .format = format, .threads = threads });
+        assert(list.vertex_count == n && "wrong vertex count");
+        assert(list.arcs == arcs && "arcs differ from the input");
+    }
+}
+
+void test_load_file() {
+    auto [text, arcs, n] = random_edge_list(gr::io::Format::plain);
+    auto path = std::filesystem::temp_directory_path() / "algo_graph_io_test.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+    }
+    auto list = gr::io::load_edge_list(path.string(), { .threads = 4, .undirected = true });
+    std::filesystem::remove(path);
+
+    std::size_t expected = 0;
+    for(auto& [u, v, w] : arcs) expected += u == v ? 1 : 2;
+    assert(list.arcs.size() == expected && "undirected load did not add reverse arcs");
+
+    auto csr = gr::io::to_csr(list);
+    auto graph = gr::io::to_graph<NodeData, gr::DijkstraEdge>(list);
+    assert(csr.vertex_count() == n && graph.nodes.size() == n);
+    assert(csr.edge_count() == expected && graph.edges.size() == expected);
+
+    auto from_graph = gr::CSRGraph<>::from_graph(graph);
+    assert(from_graph.offsets() == csr.offsets() && "to_graph and to_csr disagree");
+    assert(from_graph.targets() == csr.targets() && "to_graph and to_csr disagree");
+    assert(from_graph.weights() == csr.weights() && "to_graph and to_csr disagree");
+}
+
+void test_malformed() {
+    auto threw = false;
+    try {
+        gr::io::parse_edge_list("0 1 3\n2 x\n");
+    } catch(const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "malformed line was accepted");
+    threw = false;
+    try {
+        gr::io::parse_edge_list("p sp 2 1\na 0 1 3\n", { .format = gr::io::Format::dimacs });
+    } catch(const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "0 id accepted in a DIMACS file");
+
+    auto rejected = [](const char* text, gr::io::Format format = gr::io::Format::plain) {
+        try {
+            gr::io::parse_edge_list<std::size_t>(text, { .format = format });
+        } catch(const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejected("0 1 abc\n") && "unparsable weight was accepted");
+    assert(rejected("0 1 3.75\n") && "fractional weight was truncated");
+    assert(rejected("0 1 5 junk\n") && "trailing text was accepted");
+    assert(rejected("4294967297 1\n") && "id beyond vertex_t was narrowed");
+    assert(rejected("0 4294967295\n") && "NIL accepted as an id");
+    assert(rejected("p sp 4294967297 1\n", gr::io::Format::dimacs) && "vertex count beyond vertex_t was accepted");
+    assert(rejected("p sp 4294967295 1\n", gr::io::Format::dimacs) && "NIL accepted as a vertex count");
+    assert(rejected("p sp 2 1\na 1 2 3 4\n", gr::io::Format::dimacs) && "trailing text was accepted in a DIMACS arc");
+    assert(rejected("p sp 2 1\na 1 4294967297 3\n", gr::io::Format::dimacs) && "id beyond vertex_t was narrowed");
+
+    // blanks around a complete line are fine, the weight stays optional
+    auto list = gr::io::parse_edge_list<std::size_t>("  0 1 \t\r\n2\t3\t7  \n");
+    assert(list.vertex_count == 4 && list.arcs.size() == 2);
+    assert(std::get<2>(list.arcs[0]) == 1 && std::get<2>(list.arcs[1]) == 7);
+}
+
+int main(void) {
+    for(auto i = 0; i < 50; i++) {
+        test_parse(gr::io::Format::plain);
+        test_parse(gr::io::Format::dimacs);
+        test_load_file();
+    }
+    test_malformed();
+}
@@ -0,0 +1,292 @@
+#ifndef GRAPH_IO_HPP
+#define GRAPH_IO_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GRAPH_IO_MMAP
+#endif
+
+namespace gr::io {
+    enum class Format {
+        /// "u v" or "u v w" per line, 0-based ids, '#' and '%' start comments (SNAP style)
+        plain,
+        /// DIMACS shortest path format, "p sp n m" header and "a u v w" arcs with 1-based ids
+        dimacs,
+    };
+    struct LoadOptions {
+        Format format = Format::plain;
+        /// number of chunks parsed concurrently, 0 picks std::thread::hardware_concurrency
+        std::size_t threads = 1;
+        /// add the reverse of every arc (SNAP undirected graphs list each edge once)
+        bool undirected = false;
+    };
+
+    template <typename W = std::size_t>
+    struct EdgeList {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        using edge_tuple_t = CSRGraph<W>::edge_tuple_t;
+
+        std::size_t vertex_count{};
+        std::vector<edge_tuple_t> arcs{};
+    };
+
+    /// read-only view of a whole file, mmap'd where available and read into memory otherwise
+    class MappedFile {
+        const char* m_data = nullptr;
+        std::size_t m_size{};
+#ifdef GRAPH_IO_MMAP
+        bool m_mapped = false;
+#endif
+        std::string m_buffer{};
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifdef GRAPH_IO_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0) {
+                throw std::runtime_error("could not open " + path);
+            }
+            struct stat st{};
+            if(::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("could not stat " + path);
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            if(m_size > 0) {
+                void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(addr == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("could not mmap " + path);
+                }
+                ::madvise(addr, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(addr);
+                m_mapped = true;
+            }
+            ::close(fd);
+#else
+            std::ifstream file(path, std::ios::binary);
+            if(!file) {
+                throw std::runtime_error("could not open " + path);
+            }
+            m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+#endif
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() {
+#ifdef GRAPH_IO_MMAP
+            if(m_mapped) {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+#endif
+        }
+        inline std::string_view view() const {
+            return { m_data, m_size };
+        }
+    };
+
+    namespace {
+        inline bool is_blank(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+        template <typename N>
+        inline bool parse_field(const char*& it, const char* end, N& out) {
+            while(it < end && is_blank(*it)) it++;
+            if(it == end) return false;
+            auto [ptr, ec] = std::from_chars(it, end, out);
+            if(ec != std::errc{}) return false;
+            it = ptr;
+            return true;
+        }
+        /// true when only blanks are left on the line
+        inline bool at_line_end(const char*& it, const char* end) {
+            while(it < end && is_blank(*it)) it++;
+            return it == end;
+        }
+        inline std::runtime_error parse_error(std::string_view line) {
+            return std::runtime_error("malformed edge list line: " + std::string(line));
+        }
+
+        template <typename W>
+        struct ChunkResult {
+            std::vector<typename EdgeList<W>::edge_tuple_t> arcs{};
+            std::size_t max_id{};
+            /// vertex count from a DIMACS "p" line, 0 if the chunk had none
+            std::size_t declared_n{};
+        };
+
+        /// parses every line of the chunk into out
+        template <typename W>
+        inline void parse_chunk(std::string_view text, const LoadOptions& opt, ChunkResult<W>& out) {
+            using vertex_t = EdgeList<W>::vertex_t;
+            const char* it = text.data();
+            const char* const end = text.data() + text.size();
+
+            while(it < end) {
+                const char* line_end = std::find(it, end, '\n');
+                const char* p = it;
+                std::string_view line{ it, static_cast<std::size_t>(line_end - it) };
+                it = line_end + (line_end < end ? 1 : 0);
+
+                while(p < line_end && is_blank(*p)) p++;
+                if(p == line_end) continue;
+
+                // ids must fit vertex_t and leave NIL free
+                constexpr std::size_t MAX_ID = CSRGraph<W>::NIL;
+                std::size_t u{}, v{};
+                W w{1};
+                if(opt.format == Format::plain) {
+                    if(*p == '#' || *p == '%') continue;
+                    if(!parse_field(p, line_end, u) || !parse_field(p, line_end, v) || u >= MAX_ID || v >= MAX_ID) {
+                        throw parse_error(line);
+                    }
+                    // the weight is optional, but when present it has to be the whole rest of the line
+                    if(!at_line_end(p, line_end) && (!parse_field(p, line_end, w) || !at_line_end(p, line_end))) {
+                        throw parse_error(line);
+                    }
+                } else {
+                    auto tag = *p++;
+                    if(tag == 'c') continue;
+                    if(tag == 'p') {
+                        while(p < line_end && is_blank(*p)) p++;
+                        // skip the problem name ("sp")
+                        while(p < line_end && !is_blank(*p)) p++;
+                        std::size_t m{};
+                        if(!parse_field(p, line_end, out.declared_n) || out.declared_n >= MAX_ID ||
+                                !parse_field(p, line_end, m) || !at_line_end(p, line_end)) {
+                            throw parse_error(line);
+                        }
+                        continue;
+                    }
+                    if(tag != 'a' || !parse_field(p, line_end, u) || !parse_field(p, line_end, v) ||
+                            !parse_field(p, line_end, w) || !at_line_end(p, line_end) ||
+                            u == 0 || v == 0 || u > MAX_ID || v > MAX_ID) {
+                        throw parse_error(line);
+                    }
+                    u--;
+                    v--;
+                }
+                out.max_id = std::max({ out.max_id, u + 1, v + 1 });
+                out.arcs.emplace_back(static_cast<vertex_t>(u), static_cast<vertex_t>(v), w);
+                if(opt.undirected && u != v) {
+                    out.arcs.emplace_back(static_cast<vertex_t>(v), static_cast<vertex_t>(u), w);
+                }
+            }
+        }
+    }
+
+    /// parses an edge list held in memory in O(V+E), chunks are cut at line
+    /// boundaries and parsed in parallel, arcs keep their order in the text
+    template <typename W = std::size_t>
+    inline EdgeList<W> parse_edge_list(std::string_view text, const LoadOptions& opt = {}) {
+        auto threads = opt.threads ? opt.threads : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        threads = std::max<std::size_t>(1, std::min(threads, text.size() / 4096 + 1));
+
+        std::vector<std::string_view> chunks{};
+        std::size_t pos = 0;
+        for(std::size_t i = 0; i < threads && pos < text.size(); i++) {
+            auto cut = i + 1 == threads ? text.size() : std::max(pos, text.size() * (i + 1) / threads);
+            if(cut < text.size()) {
+                cut = text.find('\n', cut);
+                cut = cut == std::string_view::npos ? text.size() : cut + 1;
+            }
+            chunks.push_back(text.substr(pos, cut - pos));
+            pos = cut;
+        }
+
+        std::vector<ChunkResult<W>> results(chunks.size());
+        if(chunks.size() <= 1) {
+            if(!chunks.empty()) parse_chunk(chunks[0], opt, results[0]);
+        } else {
+            std::vector<std::thread> workers{};
+            std::vector<std::exception_ptr> errors(chunks.size());
+            for(std::size_t i = 0; i < chunks.size(); i++) {
+                workers.emplace_back([&, i]() {
+                    try {
+                        parse_chunk(chunks[i], opt, results[i]);
+                    } catch(...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for(auto& t : workers) t.join();
+            for(auto& e : errors) {
+                if(e) std::rethrow_exception(e);
+            }
+        }
+
+        EdgeList<W> list{};
+        std::size_t total = 0;
+        for(auto& r : results) {
+            total += r.arcs.size();
+            list.vertex_count = std::max({ list.vertex_count, r.max_id, r.declared_n });
+        }
+        if(results.size() == 1) {
+            list.arcs = std::move(results[0].arcs);
+        } else {
+            list.arcs.reserve(total);
+            for(auto& r : results) {
+                list.arcs.insert(list.arcs.end(), r.arcs.begin(), r.arcs.end());
+                r.arcs = {};
+            }
+        }
+        return list;
+    }
+    template <typename W = std::size_t>
+    inline EdgeList<W> load_edge_list(const std::string& path, const LoadOptions& opt = {}) {
+        MappedFile file{ path };
+        return parse_edge_list<W>(file.view(), opt);
+    }
+
+    /// builds the CSR graph straight from the arcs, no adjacency matrix involved
+    template <typename W>
+    inline CSRGraph<W> to_csr(const EdgeList<W>& list) {
+        return CSRGraph<W>::from_edges(list.vertex_count, list.arcs);
+    }
+    /// builds a gr::Graph with default constructed node data, every edge is
+    /// listed by both of its endpoints like Graph::from_matrix does
+    template <typename T, typename E = edge_empty_data, typename W>
+    inline Graph<T, E> to_graph(const EdgeList<W>& list) {
+        static_assert(std::is_default_constructible<T>(), "T is not default constructible");
+        static_assert(std::is_default_constructible<E>(), "E is not default constructible");
+        using graph_t = Graph<T, E>;
+        graph_t graph{};
+        std::vector<typename graph_t::node_t*> nodes_v(list.vertex_count);
+        for(std::size_t i = 0; i < list.vertex_count; i++) {
+            graph.nodes.push_back(typename graph_t::node_t{ .edges = {}, .node_data = {} });
+            nodes_v[i] = &graph.nodes.back();
+        }
+        for(auto& [u, v, w] : list.arcs) {
+            auto edge = typename graph_t::edge_t{ .tail = nodes_v[u], .head = nodes_v[v], .edge_data = {} };
+            if constexpr (std::is_convertible<E*, DijkstraEdge*>::value) {
+                static_cast<DijkstraEdge&>(edge.edge_data).dijkstra_score = static_cast<std::size_t>(w);
+            }
+            graph.edges.push_back(edge);
+            nodes_v[u]->edges.push_back(&graph.edges.back());
+            if(u != v) nodes_v[v]->edges.push_back(&graph.edges.back());
+        }
+        return graph;
+    }
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <common.hpp>
+#include <datatypes.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_mst.hpp>
+#include <vector>
+
+struct NodeData : public gr::ExplorableGraphData {
+    char name = '\0';
+    NodeData(char n) : name(n){}
+    NodeData() {};
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// random undirected graph, every edge is stored as both of its arcs
+csr_t random_graph(std::size_t n, std::size_t m, std::size_t max_weight) {
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(std::size_t i = 0; i < m; i++) {
+        vertex_t a = common::get_random_in_range(0, n - 1);
+        vertex_t b = common::get_random_in_range(0, n - 1);
+        std::size_t w = common::get_random_in_range(0, max_weight);
+        arcs.emplace_back(a, b, w);
+        arcs.emplace_back(b, a, w);
+    }
+    return csr_t::from_edges(n, arcs);
+}
+
+std::size_t forest_weight(const csr_t& g, const std::vector<std::size_t>& slots) {
+    std::size_t total = 0;
+    for(auto slot : slots) total += g.weight(slot);
+    return total;
+}
+
+/// the slots must form a forest spanning every component of g
+void verify_forest(const csr_t& g, const std::vector<std::size_t>& slots) {
+    std::vector<vertex_t> tails(g.edge_count());
+    dt::DisjointSets components{ g.vertex_count() };
+    for(vertex_t v = 0; v < g.vertex_count(); v++) {
+        for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+            tails[slot] = v;
+            components.unite(v, g.head(slot));
+        }
+    }
+    dt::DisjointSets forest{ g.vertex_count() };
+    for(auto slot : slots) {
+        assert(forest.unite(tails[slot], g.head(slot)) && "forest edges close a cycle");
+    }
+    assert(forest.count() == components.count() && "forest does not span every component");
+}
+
+void test_filter_kruskal() {
+    std::size_t n = common::get_random_in_range(1, 3000);
+    auto g = random_graph(n, common::get_random_in_range(0, 10 * n), common::get_random_in_range(0, 1000));
+    auto expected = forest_weight(g, gr::csr::kruskal_mst(g));
+
+    gr::csr::FilterKruskalOptions opt{};
+    opt.base_case = common::get_random_in_range(1, 300);
+    opt.threads = 1;
+    auto tree = gr::csr::filter_kruskal_mst(g, opt);
+    verify_forest(g, tree);
+    assert(forest_weight(g, tree) == expected && "filter_kruskal_mst is not minimal");
+    for(std::size_t i = 1; i < tree.size(); i++) {
+        assert(g.weight(tree[i - 1]) <= g.weight(tree[i]) && "forest edges are not in increasing weight");
+    }
+}
+
+/// big base cases go through the parallel sort
+void test_filter_kruskal_parallel_sort() {
+    std::size_t n = 20000;
+    auto g = random_graph(n, 100000, 1 << 20);
+    gr::csr::FilterKruskalOptions opt{};
+    opt.base_case = 1 << 20;
+    opt.threads = 4;
+    auto tree = gr::csr::filter_kruskal_mst(g, opt);
+    verify_forest(g, tree);
+    assert(forest_weight(g, tree) == forest_weight(g, gr::csr::kruskal_mst(g)));
+}
+
+void test_boruvka() {
+    std::size_t n = common::get_random_in_range(1, 3000);
+    // few edges leave plenty of components
+    auto g = random_graph(n, common::get_random_in_range(0, 3 * n), common::get_random_in_range(0, 1000));
+    auto expected = forest_weight(g, gr::csr::kruskal_mst(g));
+    for(std::size_t threads : { 1, 4 }) {
+        auto forest = gr::csr::boruvka_msf(g, threads);
+        verify_forest(g, forest);
+        assert(forest_weight(g, forest) == expected && "boruvka_msf is not minimal");
+    }
+}
+
+/// connected random graph, a path through every vertex plus extra edges
+csr_t connected_graph(std::size_t n, std::size_t m, std::size_t max_weight) {
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    auto add = [&](vertex_t a, vertex_t b) {
+        std::size_t w = common::get_random_in_range(0, max_weight);
+        arcs.emplace_back(a, b, w);
+        arcs.emplace_back(b, a, w);
+    };
+    for(vertex_t v = 1; v < n; v++) add(v - 1, v);
+    for(std::size_t i = 0; i < m; i++) add(common::get_random_in_range(0, n - 1), common::get_random_in_range(0, n - 1));
+    return csr_t::from_edges(n, arcs);
+}
+
+void test_prim() {
+    std::size_t n = common::get_random_in_range(1, 400);
+    // from sparse up to complete graphs
+    auto g = connected_graph(n, common::get_random_in_range(0, n * n / 2), common::get_random_in_range(0, 1000));
+    auto expected = forest_weight(g, gr::csr::kruskal_mst(g));
+    vertex_t start = common::get_random_in_range(0, n - 1);
+    for(auto tree : { gr::csr::prim_mst(g, start), gr::csr::prim_mst_dense(g, start) }) {
+        assert(tree.size() + 1 == n && "prim did not span the graph");
+        verify_forest(g, tree);
+        assert(forest_weight(g, tree) == expected && "prim is not minimal");
+    }
+}
+
+void test_graph_prim_on_matrix() {
+    using graph_t = gr::Graph<NodeData, gr::DijkstraEdge>;
+    std::size_t n = common::get_random_in_range(1, 40);
+    graph_t::vmatrix_e mtx(n);
+    for(std::size_t a = 0; a < n; a++) {
+        std::get<1>(mtx[a]).resize(n, { 0, 0 });
+    }
+    for(std::size_t a = 0; a < n; a++) {
+        for(std::size_t b = a + 1; b < n; b++) {
+            std::size_t w = common::get_random_in_range(1, 100);
+            std::get<1>(mtx[a])[b] = { 1, w };
+            std::get<1>(mtx[b])[a] = { 1, w };
+        }
+    }
+    auto graph = graph_t::from_matrix(mtx);
+    auto cost = [](const auto& tree) {
+        std::size_t total = 0;
+        for(auto* e : tree) total += e->edge_data.dijkstra_score;
+        return total;
+    };
+    auto expected = cost(gr::kruskal_mst(graph));
+    auto* start = &graph.nodes.back();
+    for(auto tree : { gr::prim_mst_heap(graph, start), gr::prim_mst_dense(graph, start) }) {
+        assert(tree.size() + 1 == n && cost(tree) == expected && "prim on a complete graph is not minimal");
+    }
+}
+
+void test_graph_mst_leaves_graph_alone() {
+    using graph_t = gr::Graph<NodeData, gr::DijkstraEdge>;
+    using edge_t = graph_t::edge_t;
+    graph_t::vmatrix_e mtx = {{
+        //         a       b       c       d        e
+        { 'a', { {0, 0}, {1, 1}, {1, 4}, {1, 3}, {0, 0} } },
+        { 'b', { {1, 1}, {0, 0}, {0, 0}, {1, 2}, {0, 0} } },
+        { 'c', { {1, 4}, {0, 0}, {0, 0}, {1, 5}, {1, 4} } },
+        { 'd', { {1, 3}, {1, 2}, {1, 5}, {0, 0}, {1, 6} } },
+        { 'e', { {0, 0}, {0, 0}, {1, 4}, {1, 6}, {0, 0} } },
+    }};
+    auto graph = graph_t::from_matrix(mtx);
+    std::vector<edge_t*> before{};
+    for(auto& e : graph.edges) before.push_back(&e);
+
+    for(auto tree : { gr::filter_kruskal_mst(graph), gr::kruskal_mst(graph), gr::boruvka_msf(graph, 2),
+            gr::prim_mst_heap(graph, &graph.nodes.front()), gr::prim_mst_dense(graph, &graph.nodes.front()) }) {
+        std::size_t total = 0;
+        for(auto* e : tree) total += e->edge_data.dijkstra_score;
+        assert(tree.size() == 4 && total == 11 && "wrong spanning tree");
+    }
+    std::size_t i = 0;
+    for(auto& e : graph.edges) {
+        assert(&e == before[i++] && "the mst reordered the edges of the graph");
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_filter_kruskal();
+        test_boruvka();
+        test_prim();
+        test_graph_prim_on_matrix();
+    }
+    test_filter_kruskal_parallel_sort();
+    test_graph_mst_leaves_graph_alone();
+}
@@ -0,0 +1,289 @@
+#ifndef GRAPH_MST_HPP
+#define GRAPH_MST_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <datatypes.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <limits>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    struct FilterKruskalOptions {
+        /// ranges up to this many edges (or the vertex count when larger) are
+        /// sorted and scanned instead of being partitioned further
+        std::size_t base_case = 1 << 12;
+        /// workers for sorting the base cases, 0 uses std::thread::hardware_concurrency
+        std::size_t threads = 0;
+    };
+
+    namespace {
+        /// std::sort on threads chunks followed by rounds of pairwise merges
+        template <typename T>
+        inline void parallel_sort(std::vector<T>& v, std::size_t begin, std::size_t end, std::size_t threads) {
+            constexpr std::size_t MIN_CHUNK = 1 << 14;
+            auto const size = end - begin;
+            threads = std::min(threads, size / MIN_CHUNK);
+            if(threads <= 1) {
+                std::sort(v.begin() + begin, v.begin() + end);
+                return;
+            }
+            std::vector<std::size_t> bounds(threads + 1);
+            for(std::size_t t = 0; t <= threads; t++) {
+                bounds[t] = begin + size * t / threads;
+            }
+            auto run = [](std::size_t jobs, auto&& job) {
+                std::vector<std::thread> workers{};
+                for(std::size_t j = 1; j < jobs; j++) {
+                    workers.emplace_back(job, j);
+                }
+                job(0);
+                for(auto& w : workers) w.join();
+            };
+            run(threads, [&](std::size_t t) {
+                std::sort(v.begin() + bounds[t], v.begin() + bounds[t + 1]);
+            });
+            for(std::size_t width = 1; width < threads; width *= 2) {
+                run((threads + 2 * width - 1) / (2 * width), [&](std::size_t j) {
+                    auto first = j * 2 * width;
+                    auto middle = std::min(first + width, threads);
+                    auto last = std::min(first + 2 * width, threads);
+                    if(middle == last) return;
+                    std::inplace_merge(v.begin() + bounds[first], v.begin() + bounds[middle], v.begin() + bounds[last]);
+                });
+            }
+        }
+    }
+
+    /// Filter-Kruskal minimum spanning forest, returns the slots of the forest
+    /// edges in increasing weight. Edges are (weight, slot) pairs in one array
+    /// that is split quicksort style around a pivot weight: the light part is
+    /// solved first and the heavy part then loses every edge whose endpoints
+    /// are already connected, so heavy edges that cannot join the forest are
+    /// never sorted. Arcs are treated as undirected edges
+    template <typename W>
+    inline std::vector<std::size_t> filter_kruskal_mst(const CSRGraph<W>& g, FilterKruskalOptions opt = {}) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        std::vector<std::pair<W, std::size_t>> edges(g.edge_count());
+        std::vector<vertex_t> tails(g.edge_count());
+        for(vertex_t v = 0; v < g.vertex_count(); v++) {
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                edges[slot] = { g.weight(slot), slot };
+                tails[slot] = v;
+            }
+        }
+        auto const threads = worker_count(opt.threads);
+        auto const base_case = std::max<std::size_t>({ opt.base_case, g.vertex_count(), 1 });
+
+        std::vector<std::size_t> tree{};
+        dt::DisjointSets sets{ g.vertex_count() };
+        auto kruskal = [&](std::size_t begin, std::size_t end) {
+            parallel_sort(edges, begin, end, threads);
+            for(auto i = begin; i < end && tree.size() + 1 < g.vertex_count(); i++) {
+                auto slot = edges[i].second;
+                if(sets.unite(tails[slot], g.head(slot))) {
+                    tree.push_back(slot);
+                }
+            }
+        };
+        // moves the edges that can still join the forest to the front
+        auto filter = [&](std::size_t begin, std::size_t end) {
+            auto keep = std::partition(edges.begin() + begin, edges.begin() + end, [&](const auto& e) {
+                return !sets.same_set(tails[e.second], g.head(e.second));
+            });
+            return static_cast<std::size_t>(keep - edges.begin());
+        };
+
+        // (begin, end, filter first), the light half is on top so it is done first
+        std::vector<std::tuple<std::size_t, std::size_t, bool>> stack{ { 0, edges.size(), false } };
+        while(!stack.empty()) {
+            auto [begin, end, heavy] = stack.back();
+            stack.pop_back();
+            if(tree.size() + 1 >= g.vertex_count()) break;
+            if(heavy) end = filter(begin, end);
+            if(end - begin <= base_case) {
+                kruskal(begin, end);
+                continue;
+            }
+            // median of three weights as the pivot
+            W a = edges[begin].first, b = edges[begin + (end - begin) / 2].first, c = edges[end - 1].first;
+            W pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+            auto split = std::partition(edges.begin() + begin, edges.begin() + end, [&](const auto& e) {
+                return e.first < pivot;
+            }) - edges.begin();
+            if(static_cast<std::size_t>(split) == begin) {
+                split = std::partition(edges.begin() + begin, edges.begin() + end, [&](const auto& e) {
+                    return !(pivot < e.first);
+                }) - edges.begin();
+            }
+            if(static_cast<std::size_t>(split) == end) {
+                // every weight equals the pivot
+                kruskal(begin, end);
+                continue;
+            }
+            stack.emplace_back(split, end, true);
+            stack.emplace_back(begin, split, false);
+        }
+        return tree;
+    }
+
+    /// Boruvka minimum spanning forest, returns the slots of the forest edges
+    /// in no particular order. Every round each component picks its lightest
+    /// outgoing edge (ties broken by slot so the choices cannot form a cycle)
+    /// with an atomic minimum while the active edges are scanned in parallel,
+    /// then the picked edges are united concurrently, which also contracts the
+    /// components. Edges inside one component are dropped for good, and a
+    /// component without outgoing edges is finished, so disconnected graphs
+    /// end up with one tree per component. Arcs are treated as undirected edges
+    template <typename W>
+    inline std::vector<std::size_t> boruvka_msf(const CSRGraph<W>& g, std::size_t threads = 0) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+        threads = worker_count(threads);
+        auto const n = g.vertex_count();
+
+        std::vector<vertex_t> tails(g.edge_count());
+        std::vector<std::size_t> active{};
+        active.reserve(g.edge_count());
+        for(vertex_t v = 0; v < n; v++) {
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                tails[slot] = v;
+                if(g.head(slot) != v) active.push_back(slot);
+            }
+        }
+        // live components by their root, size_t like the slots because expand_frontier keeps its element type
+        std::vector<std::size_t> roots(n);
+        for(std::size_t v = 0; v < n; v++) roots[v] = v;
+
+        dt::ConcurrentDisjointSets sets{ n };
+        std::vector<std::atomic<std::size_t>> best(n);
+        for(auto& b : best) b.store(NONE, std::memory_order_relaxed);
+        auto lighter = [&](std::size_t a, std::size_t b) {
+            return g.weight(a) < g.weight(b) || (!(g.weight(b) < g.weight(a)) && a < b);
+        };
+        auto relax = [&](std::size_t component, std::size_t slot) {
+            auto current = best[component].load(std::memory_order_relaxed);
+            while((current == NONE || lighter(slot, current))
+                    && !best[component].compare_exchange_weak(current, slot, std::memory_order_relaxed)) {}
+        };
+
+        std::vector<std::size_t> tree{};
+        while(true) {
+            active = expand_frontier(active, threads, [&](std::size_t slot, std::vector<std::size_t>& out) {
+                auto a = sets.find(tails[slot]), b = sets.find(g.head(slot));
+                if(a == b) return;
+                out.push_back(slot);
+                relax(a, slot);
+                relax(b, slot);
+            });
+            if(active.empty()) break;
+            auto added = expand_frontier(roots, threads, [&](std::size_t c, std::vector<std::size_t>& out) {
+                auto slot = best[c].exchange(NONE, std::memory_order_relaxed);
+                if(slot != NONE && sets.unite(tails[slot], g.head(slot))) out.push_back(slot);
+            });
+            tree.insert(tree.end(), added.begin(), added.end());
+            roots = expand_frontier(roots, threads, [&](std::size_t c, std::vector<std::size_t>& out) {
+                if(sets.find(c) == c) out.push_back(c);
+            });
+        }
+        return tree;
+    }
+
+    /// Prim's algorithm for dense graphs, like the complete distance graphs
+    /// built from adjacency matrices. The lightest arc of every pair goes into
+    /// an n x n slot matrix, and each step relaxes one matrix row and picks
+    /// the next vertex in the same scan over a plain key array. That is
+    /// O(V^2) with no heap at all, which wins once E approaches V^2. Returns
+    /// the slots of the tree grown from start like prim_mst
+    template <typename W>
+    inline std::vector<std::size_t> prim_mst_dense(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+        std::size_t const n = g.vertex_count();
+        std::vector<std::size_t> matrix(n * n, NONE);
+        for(vertex_t v = 0; v < n; v++) {
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                auto& at = matrix[v * n + g.head(slot)];
+                if(at == NONE || g.weight(slot) < g.weight(at)) at = slot;
+            }
+        }
+
+        std::vector<std::size_t> tree{};
+        std::vector<W> key(n);
+        std::vector<std::size_t> winner(n, NONE);
+        std::vector<bool> explored(n);
+        for(std::size_t v = start; v != NONE;) {
+            explored[v] = true;
+            if(winner[v] != NONE) tree.push_back(winner[v]);
+            const std::size_t* row = &matrix[v * n];
+            std::size_t next = NONE;
+            for(std::size_t u = 0; u < n; u++) {
+                if(explored[u]) continue;
+                if(auto slot = row[u]; slot != NONE && (winner[u] == NONE || g.weight(slot) < key[u])) {
+                    key[u] = g.weight(slot);
+                    winner[u] = slot;
+                }
+                if(winner[u] != NONE && (next == NONE || key[u] < key[next])) next = u;
+            }
+            v = next;
+        }
+        return tree;
+    }
+}
+
+namespace gr {
+    /// filter_kruskal_mst for a gr::Graph, the graph itself is left untouched
+    template <typename T, typename E,
+             typename G = Graph<T, E>,
+             typename ED = G::edge_t>
+    inline std::vector<ED*> filter_kruskal_mst(Graph<T, E>& graph, csr::FilterKruskalOptions opt = {}) {
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from gr::DijkstraEdge");
+        GraphIndex<T, E> index{ graph };
+        auto g = CSRGraph<>::from_graph(index);
+        std::vector<ED*> tree{};
+        for(auto slot : csr::filter_kruskal_mst(g, opt)) {
+            tree.push_back(index.edges[g.edge_ref(slot)]);
+        }
+        return tree;
+    }
+
+    /// boruvka_msf for a gr::Graph, one tree for every connected component
+    template <typename T, typename E,
+             typename G = Graph<T, E>,
+             typename ED = G::edge_t>
+    inline std::vector<ED*> boruvka_msf(Graph<T, E>& graph, std::size_t threads = 0) {
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from gr::DijkstraEdge");
+        GraphIndex<T, E> index{ graph };
+        auto g = CSRGraph<>::from_graph(index);
+        std::vector<ED*> tree{};
+        for(auto slot : csr::boruvka_msf(g, threads)) {
+            tree.push_back(index.edges[g.edge_ref(slot)]);
+        }
+        return tree;
+    }
+
+    /// csr::prim_mst_dense for a gr::Graph, meant for graphs from Graph::from_matrix
+    template <typename T, typename E,
+             typename G = Graph<T, E>,
+             typename N = G::node_t,
+             typename ED = G::edge_t>
+    inline std::vector<ED*> prim_mst_dense(Graph<T, E>& graph, N* start) {
+        static_assert(std::is_convertible<E*, DijkstraEdge*>::value, "E must be derived from gr::DijkstraEdge");
+        GraphIndex<T, E> index{ graph };
+        auto g = CSRGraph<>::from_graph(index);
+        std::vector<ED*> tree{};
+        for(auto slot : csr::prim_mst_dense(g, static_cast<CSRGraph<>::vertex_t>(index.id(start)))) {
+            tree.push_back(index.edges[g.edge_ref(slot)]);
+        }
+        return tree;
+    }
+}
+
+#endif
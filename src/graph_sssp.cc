@@ -0,0 +1,501 @@
+#include <chrono>
+#include <cmath>
+#include <common.hpp>
+#include <graph.hpp>
+#include <graph_csr.hpp>
+#include <graph_sssp.hpp>
+#include <print>
+#include <vector>
+
+struct EdgeData : public gr::DijkstraEdge {
+    EdgeData(decltype(gr::DijkstraEdge::dijkstra_score) s) : gr::DijkstraEdge(s) {}
+    EdgeData() {}
+};
+struct NodeData : public gr::Graph<NodeData, EdgeData>::DijkstraData {
+    NodeData(){}
+};
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// length of the arc slots, checking that they form a walk from start to end
+template <typename W>
+W walk_length(const gr::CSRGraph<W>& g, const std::vector<std::size_t>& slots, vertex_t start, vertex_t end) {
+    W len = 0;
+    auto at = start;
+    for(auto slot : slots) {
+        assert(slot >= g.edge_begin(at) && slot < g.edge_end(at) && "path slot does not leave the current vertex");
+        len += g.weight(slot);
+        at = g.head(slot);
+    }
+    assert(at == end && "path does not end at the target");
+    return len;
+}
+
+void test_engine_matches_dijkstra() {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 1500), 100);
+    gr::csr::DijkstraEngine<std::size_t> engine{ g };
+    // the same engine serves every query
+    for(auto q = 0; q < 20; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        engine.run(s);
+        auto expected = gr::csr::dijkstra(g, s);
+        assert(engine.distances() == expected && "engine differs from csr::dijkstra");
+
+        vertex_t t = common::get_random_in_range(0, n - 1);
+        auto reached = engine.run(s, t);
+        assert(reached == (expected[t] != csr_t::INF));
+        assert(engine.distance(t) == expected[t] && "early stop gave the wrong distance");
+        if(!reached) {
+            assert(engine.path(t).empty() && engine.path_slots(t).empty());
+            continue;
+        }
+        auto path = engine.path(t);
+        assert(path.front() == s && path.back() == t);
+        assert(walk_length(g, engine.path_slots(t), s, t) == expected[t] && "path is not a shortest one");
+    }
+}
+
+void test_engine_matches_dijkstra_h() {
+    // from_matrix lists every edge with both endpoints, the engine must only follow out-arcs
+    std::size_t n = common::get_random_in_range(2, 30);
+    gr::Graph<NodeData, EdgeData>::vmatrix_e mtx(n);
+    for(auto& [data, row] : mtx) {
+        row.resize(n);
+        for(auto& [connected, e] : row) {
+            connected = common::get_random_in_range(1, 100) <= 20;
+            e = EdgeData(common::get_random_in_range(1, 50));
+        }
+    }
+    auto graph = gr::Graph<NodeData, EdgeData>::from_matrix(mtx);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto g = csr_t::from_graph(index);
+    gr::csr::DijkstraEngine<std::size_t> engine{ g };
+    for(vertex_t s = 0; s < n; s++) {
+        gr::dijkstra_h(graph, index.nodes[s]);
+        engine.run(s);
+        for(vertex_t v = 0; v < n; v++) {
+            assert(engine.distance(v) == index.nodes[v]->node_data.len && "engine differs from gr::dijkstra_h");
+        }
+    }
+}
+
+void test_monotone_queue_engines() {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 1500), common::get_random_in_range(0, 20));
+    auto dial = gr::csr::make_dial_engine(g);
+    gr::csr::RadixDijkstraEngine<std::size_t> radix{ g };
+    gr::csr::MonotoneDijkstraEngine<std::size_t> monotone{ g };
+    for(auto q = 0; q < 20; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        auto expected = gr::csr::dijkstra(g, s);
+        dial.run(s);
+        radix.run(s);
+        monotone.run(s);
+        assert(dial.distances() == expected && "Dial's engine differs from csr::dijkstra");
+        assert(radix.distances() == expected && "radix heap engine differs from csr::dijkstra");
+        assert(monotone.distances() == expected && "monotone engine differs from csr::dijkstra");
+
+        vertex_t t = common::get_random_in_range(0, n - 1);
+        if(dial.run(s, t)) {
+            assert(walk_length(g, dial.path_slots(t), s, t) == expected[t] && "Dial's path is not a shortest one");
+        }
+        if(radix.run(s, t)) {
+            assert(walk_length(g, radix.path_slots(t), s, t) == expected[t] && "radix heap path is not a shortest one");
+        }
+    }
+}
+
+void test_bidirectional_engine() {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 1000), 100);
+    auto rev = g.transpose();
+    gr::csr::BidirectionalDijkstraEngine<std::size_t> engine{ g, rev };
+    std::vector<std::size_t> slot_of_ref(g.edge_count());
+    for(std::size_t slot = 0; slot < g.edge_count(); slot++) {
+        slot_of_ref[g.edge_ref(slot)] = slot;
+    }
+    for(auto q = 0; q < 20; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        vertex_t t = common::get_random_in_range(0, n - 1);
+        auto expected = gr::csr::dijkstra(g, s)[t];
+        assert(engine.run(s, t) == expected && "bidirectional distance differs from csr::dijkstra");
+        auto path = engine.path();
+        auto refs = engine.path_refs();
+        if(expected == csr_t::INF) {
+            assert(path.empty() && refs.empty());
+            continue;
+        }
+        assert(path.front() == s && path.back() == t && refs.size() + 1 == path.size());
+        // refs are positions in the arc list, map them back to slots of g
+        for(auto& ref : refs) ref = slot_of_ref[ref];
+        assert(walk_length(g, refs, s, t) == expected && "bidirectional path is not a shortest one");
+    }
+}
+
+void test_astar_and_alt() {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 1000), 100);
+    auto rev = g.transpose();
+    gr::csr::AltLandmarks<std::size_t> alt{ g, rev, 4, static_cast<vertex_t>(common::get_random_in_range(0, n - 1)) };
+    gr::csr::AStarEngine<std::size_t> astar{ g };
+
+    for(vertex_t s = 0; s < n; s += common::get_random_in_range(1, 20)) {
+        auto len = gr::csr::dijkstra(g, s);
+        // admissible: the bound never exceeds the real distance, INF only when unreachable
+        for(vertex_t v = 0; v < n; v++) {
+            auto bound = alt.bound(s, v);
+            assert((bound == csr_t::INF ? len[v] == csr_t::INF : bound <= len[v]) && "ALT bound is not admissible");
+        }
+        for(auto q = 0; q < 5; q++) {
+            vertex_t t = common::get_random_in_range(0, n - 1);
+            assert(astar.run(s, t, [](vertex_t) { return std::size_t{0}; }) == len[t] && "A* without a heuristic differs from dijkstra");
+            assert(astar.run(s, t, alt.heuristic(t)) == len[t] && "ALT A* differs from dijkstra");
+            if(len[t] == csr_t::INF) {
+                assert(astar.path().empty());
+                continue;
+            }
+            auto path = astar.path();
+            assert(path.front() == s && path.back() == t);
+            assert(walk_length(g, astar.path_slots(), s, t) == len[t] && "A* path is not a shortest one");
+        }
+    }
+}
+
+void test_alt_on_graph() {
+    std::size_t n = common::get_random_in_range(2, 40);
+    gr::Graph<NodeData, EdgeData>::vmatrix_e mtx(n);
+    for(auto& [data, row] : mtx) {
+        row.resize(n);
+        for(auto& [connected, e] : row) {
+            connected = common::get_random_in_range(1, 100) <= 15;
+            e = EdgeData(common::get_random_in_range(1, 50));
+        }
+    }
+    auto graph = gr::Graph<NodeData, EdgeData>::from_matrix(mtx);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto g = csr_t::from_graph(index);
+    gr::csr::AltLandmarks<std::size_t> alt{ g, g.transpose(), 3 };
+
+    for(vertex_t s = 0; s < n; s++) {
+        auto len = gr::csr::dijkstra(g, s);
+        vertex_t t = common::get_random_in_range(0, n - 1);
+        auto path = gr::astar_shortest_path(graph, index.nodes[s], index.nodes[t], gr::csr::alt_heuristic(alt, index, index.nodes[t]));
+        if(len[t] == csr_t::INF) {
+            assert(path.empty() && "A* found a path to an unreachable node");
+            continue;
+        }
+        // the path runs from t back to s
+        assert(path.front() == index.nodes[t] && path.back() == index.nodes[s]);
+        std::size_t path_len = 0;
+        for(std::size_t i = 1; i < path.size(); i++) {
+            auto best = csr_t::INF;
+            for(auto* e : path[i]->edges) {
+                if(e->tail == path[i] && e->head == path[i - 1]) best = std::min(best, e->edge_data.dijkstra_score);
+            }
+            assert(best != csr_t::INF && "A* path uses a missing edge");
+            path_len += best;
+        }
+        assert(path_len == len[t] && "gr::astar_shortest_path is not a shortest path");
+    }
+}
+
+void test_delta_stepping() {
+    std::size_t n = common::get_random_in_range(1, 500);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 4000), common::get_random_in_range(0, 100));
+    vertex_t s = common::get_random_in_range(0, n - 1);
+    auto expected = gr::csr::dijkstra(g, s);
+    // default delta, a tiny one (every arc heavy) and a huge one (bellman-ford like)
+    for(double delta : { 0.0, 1.0, 7.0, 1000.0 }) {
+        for(std::size_t threads : { 1, 4 }) {
+            auto len = gr::csr::delta_stepping(g, s, { .delta = delta, .threads = threads });
+            assert(len == expected && "delta_stepping differs from csr::dijkstra");
+        }
+    }
+
+    std::vector<gr::CSRGraph<double>::edge_tuple_t> arcs{};
+    for(vertex_t v = 0; v < g.vertex_count(); v++) {
+        for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+            arcs.emplace_back(v, g.head(slot), g.weight(slot) * 0.5);
+        }
+    }
+    auto halved = gr::CSRGraph<double>::from_edges(n, arcs);
+    auto len = gr::csr::delta_stepping(halved, s, { .delta = 3.5, .threads = 3 });
+    for(std::size_t v = 0; v < n; v++) {
+        if(expected[v] == csr_t::INF) {
+            assert(len[v] == gr::CSRGraph<double>::INF);
+        } else {
+            assert(len[v] == expected[v] * 0.5 && "delta_stepping with double weights is off");
+        }
+    }
+}
+
+/// a small explicit delta next to very heavy arcs must neither allocate a
+/// bucket per delta step nor overflow the bucket index
+void test_delta_stepping_heavy_arcs() {
+    auto pair = csr_t::from_edges(2, { { 0, 1, 1000000000000 } });
+    for(std::size_t threads : { 1, 3 }) {
+        auto len = gr::csr::delta_stepping(pair, 0, { .delta = 1, .threads = threads });
+        assert(len[1] == 1000000000000 && "delta_stepping lost a heavy arc");
+    }
+
+    std::size_t n = common::get_random_in_range(2, 300);
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(auto i = common::get_random_in_range(1, 2000); i > 0; i--) {
+        vertex_t a = common::get_random_in_range(0, n - 1), b = common::get_random_in_range(0, n - 1);
+        // a mix of light arcs and ones up to ~2^40
+        std::size_t w = common::get_random_in_range(0, 1) ? common::get_random_in_range(0, 10)
+            : static_cast<std::size_t>(common::get_random_in_range(1, 1 << 20)) << 20;
+        arcs.emplace_back(a, b, w);
+    }
+    auto g = csr_t::from_edges(n, arcs);
+    vertex_t s = common::get_random_in_range(0, n - 1);
+    auto len = gr::csr::delta_stepping(g, s, { .delta = 1, .threads = 2 });
+    assert(len == gr::csr::dijkstra(g, s) && "delta_stepping with heavy arcs differs from csr::dijkstra");
+
+    std::vector<gr::CSRGraph<double>::edge_tuple_t> real{};
+    // scaled by a power of two so every path length stays exact
+    for(auto [a, b, w] : arcs) real.emplace_back(a, b, std::ldexp(static_cast<double>(w), 600));
+    auto huge = gr::CSRGraph<double>::from_edges(n, real);
+    auto expected = gr::csr::dijkstra(huge, s);
+    auto got = gr::csr::delta_stepping(huge, s, { .delta = 1e-300, .threads = 2 });
+    assert(got == expected && "a tiny double delta broke delta_stepping");
+}
+
+void test_delta_stepping_matches_dijkstra_h() {
+    std::size_t n = common::get_random_in_range(2, 30);
+    gr::Graph<NodeData, EdgeData>::vmatrix_e mtx(n);
+    for(auto& [data, row] : mtx) {
+        row.resize(n);
+        for(auto& [connected, e] : row) {
+            connected = common::get_random_in_range(1, 100) <= 20;
+            e = EdgeData(common::get_random_in_range(1, 50));
+        }
+    }
+    auto graph = gr::Graph<NodeData, EdgeData>::from_matrix(mtx);
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto g = csr_t::from_graph(index);
+    for(vertex_t s = 0; s < n; s++) {
+        gr::dijkstra_h(graph, index.nodes[s]);
+        auto len = gr::csr::delta_stepping(g, s, { .delta = 10, .threads = 2 });
+        for(vertex_t v = 0; v < n; v++) {
+            assert(len[v] == index.nodes[v]->node_data.len && "delta_stepping differs from gr::dijkstra_h");
+        }
+    }
+}
+
+/// engines built without an explicit queue must still size Dial's buckets for the heaviest arc
+void test_dial_engine_sized_from_graph() {
+    auto g = csr_t::from_edges(3, { { 0, 1, 5 }, { 1, 2, 7 }, { 0, 2, 20 } });
+    gr::csr::DialDijkstraEngine<std::size_t> dial{ g };
+    dial.run(0);
+    assert(dial.distances() == std::vector<std::size_t>({ 0, 5, 12 }) && "Dial's buckets wrapped around");
+
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto random = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 1500), common::get_random_in_range(2, 300));
+    gr::csr::DialDijkstraEngine<std::size_t> engine{ random };
+    gr::csr::BatchDijkstra<std::size_t, dt::DialQueue<std::size_t>> batch{ random, 2 };
+    std::vector<vertex_t> sources{};
+    for(auto q = 0; q < 10; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        sources.push_back(s);
+        engine.run(s);
+        assert(engine.distances() == gr::csr::dijkstra(random, s) && "DialDijkstraEngine differs from csr::dijkstra");
+    }
+    auto rows = batch.distances(sources);
+    for(std::size_t i = 0; i < sources.size(); i++) {
+        assert(rows[i] == gr::csr::dijkstra(random, sources[i]) && "Dial batch differs from csr::dijkstra");
+    }
+}
+
+void test_batch_dijkstra() {
+    std::size_t n = common::get_random_in_range(1, 300);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 2000), 100);
+    std::vector<vertex_t> sources(common::get_random_in_range(0, 40));
+    std::vector<vertex_t> targets(common::get_random_in_range(1, 10));
+    for(auto& s : sources) s = common::get_random_in_range(0, n - 1);
+    for(auto& t : targets) t = common::get_random_in_range(0, n - 1);
+
+    gr::csr::BatchDijkstra<std::size_t> batch{ g, 4 };
+    auto full = batch.distances(sources);
+    auto some = batch.distances(sources, targets);
+    auto trees = batch.trees(sources);
+    assert(full.size() == sources.size() && some.size() == sources.size() && trees.size() == sources.size());
+    for(std::size_t i = 0; i < sources.size(); i++) {
+        auto expected = gr::csr::dijkstra(g, sources[i]);
+        assert(full[i] == expected && "batch row differs from csr::dijkstra");
+        for(std::size_t j = 0; j < targets.size(); j++) {
+            assert(some[i][j] == expected[targets[j]] && "batch target column differs from csr::dijkstra");
+        }
+        auto& tree = trees[i];
+        assert(tree.source == sources[i] && tree.len == expected);
+        for(vertex_t v = 0; v < n; v++) {
+            if(v == tree.source || tree.len[v] == csr_t::INF) {
+                assert(tree.parent[v] == csr_t::NIL);
+                continue;
+            }
+            auto slot = tree.parent_slot[v];
+            assert(g.head(slot) == v && slot >= g.edge_begin(tree.parent[v]) && slot < g.edge_end(tree.parent[v]));
+            assert(tree.len[tree.parent[v]] + g.weight(slot) == tree.len[v] && "tree arc is not tight");
+        }
+    }
+}
+
+/// graph with negative arcs but no negative cycle: w(u, v) + p(u) - p(v)
+/// shifts every distance by p(s) - p(t) and keeps cycles non-negative
+struct ShiftedGraph {
+    csr_t original;
+    gr::CSRGraph<long long> shifted;
+    std::vector<long long> potential;
+};
+ShiftedGraph random_shifted(std::size_t n, std::size_t m) {
+    ShiftedGraph sg{ .original = common::get_random_graph<csr_t>(n, m, 100), .shifted = {}, .potential = std::vector<long long>(n) };
+    for(auto& p : sg.potential) p = common::get_random_in_range(0, 80);
+    std::vector<gr::CSRGraph<long long>::edge_tuple_t> arcs{};
+    for(vertex_t v = 0; v < n; v++) {
+        for(auto slot = sg.original.edge_begin(v); slot < sg.original.edge_end(v); slot++) {
+            auto h = sg.original.head(slot);
+            arcs.emplace_back(v, h, static_cast<long long>(sg.original.weight(slot)) + sg.potential[v] - sg.potential[h]);
+        }
+    }
+    sg.shifted = gr::CSRGraph<long long>::from_edges(n, arcs);
+    return sg;
+}
+
+void test_bellman_ford() {
+    std::size_t n = common::get_random_in_range(1, 200);
+    auto sg = random_shifted(n, common::get_random_in_range(0, 1000));
+    using long_csr_t = gr::CSRGraph<long long>;
+    for(auto q = 0; q < 10; q++) {
+        vertex_t s = common::get_random_in_range(0, n - 1);
+        auto expected = gr::csr::dijkstra(sg.original, s);
+        auto r = gr::csr::bellman_ford(sg.shifted, s);
+        assert(!r.negative_cycle);
+        for(vertex_t v = 0; v < n; v++) {
+            if(expected[v] == csr_t::INF) {
+                assert(r.len[v] == long_csr_t::INF && r.parent[v] == long_csr_t::NIL);
+                continue;
+            }
+            assert(r.len[v] == static_cast<long long>(expected[v]) + sg.potential[s] - sg.potential[v] && "bellman_ford distance is wrong");
+            if(v == s) continue;
+            auto slot = r.parent_slot[v];
+            assert(sg.shifted.head(slot) == v && r.len[r.parent[v]] + sg.shifted.weight(slot) == r.len[v] && "parent arc is not tight");
+        }
+    }
+
+    // plant a negative cycle on three random vertices
+    std::vector<long_csr_t::edge_tuple_t> arcs{};
+    for(vertex_t v = 0; v < n; v++) {
+        for(auto slot = sg.shifted.edge_begin(v); slot < sg.shifted.edge_end(v); slot++) {
+            arcs.emplace_back(v, sg.shifted.head(slot), sg.shifted.weight(slot));
+        }
+    }
+    vertex_t a = common::get_random_in_range(0, n - 1), b = common::get_random_in_range(0, n - 1);
+    arcs.emplace_back(a, b, 1);
+    arcs.emplace_back(b, a, -2 - 2 * 80);
+    auto cyclic = long_csr_t::from_edges(n, arcs);
+    auto r = gr::csr::bellman_ford(cyclic, a);
+    assert(r.negative_cycle && "negative cycle not detected");
+    long long cycle_len = 0;
+    for(std::size_t i = 0; i < r.cycle.size(); i++) {
+        auto u = r.cycle[i], v = r.cycle[(i + 1) % r.cycle.size()];
+        auto best = long_csr_t::INF;
+        for(auto slot = cyclic.edge_begin(u); slot < cyclic.edge_end(u); slot++) {
+            if(cyclic.head(slot) == v) best = std::min(best, cyclic.weight(slot));
+        }
+        assert(best != long_csr_t::INF && "cycle follows a missing arc");
+        cycle_len += best;
+    }
+    assert(cycle_len < 0 && "reported cycle is not negative");
+    bool thrown = false;
+    try {
+        gr::csr::Johnson<long long> johnson{ cyclic };
+    } catch(const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "Johnson accepted a negative cycle");
+}
+
+void test_johnson() {
+    std::size_t n = common::get_random_in_range(1, 150);
+    auto sg = random_shifted(n, common::get_random_in_range(0, 800));
+    gr::csr::Johnson<long long> johnson{ sg.shifted };
+    for(auto w : johnson.reweighted().weights()) assert(w >= 0 && "reweighted arc is negative");
+
+    std::vector<vertex_t> sources(common::get_random_in_range(0, 10));
+    for(auto& s : sources) s = common::get_random_in_range(0, n - 1);
+    auto matrix = johnson.all_pairs(sources, 3);
+    for(std::size_t i = 0; i < sources.size(); i++) {
+        auto s = sources[i];
+        auto r = gr::csr::bellman_ford(sg.shifted, s);
+        assert(johnson.distances(s) == r.len && "Johnson differs from bellman_ford");
+        assert(matrix[i] == r.len && "Johnson all pairs differs from bellman_ford");
+        vertex_t t = common::get_random_in_range(0, n - 1);
+        auto slots = johnson.path_slots(s, t);
+        if(r.len[t] == gr::CSRGraph<long long>::INF) {
+            assert(slots.empty());
+        } else {
+            assert(walk_length(sg.shifted, slots, s, t) == r.len[t] && "Johnson path is not a shortest one");
+        }
+    }
+}
+
+/// many sources with gr::dijkstra_h one after another against one batch
+void bench_batch_dijkstra() {
+    std::size_t n = 2000;
+    gr::Graph<NodeData, EdgeData> graph{};
+    std::vector<gr::Graph<NodeData, EdgeData>::node_t*> nodes(n);
+    for(auto& node : nodes) {
+        graph.nodes.push_back({ .edges = {}, .node_data = {} });
+        node = &graph.nodes.back();
+    }
+    for(std::size_t i = 0; i < 8 * n; i++) {
+        auto* a = nodes[common::get_random_in_range(0, n - 1)];
+        auto* b = nodes[common::get_random_in_range(0, n - 1)];
+        graph.edges.push_back({ .tail = a, .head = b, .edge_data = EdgeData(common::get_random_in_range(1, 100)) });
+        a->edges.push_back(&graph.edges.back());
+        if(a != b) b->edges.push_back(&graph.edges.back());
+    }
+    gr::GraphIndex<NodeData, EdgeData> index{ graph };
+    auto g = csr_t::from_graph(index);
+    std::vector<vertex_t> sources(200);
+    for(auto& s : sources) s = common::get_random_in_range(0, n - 1);
+
+    auto clock_start = std::chrono::steady_clock::now();
+    std::vector<std::vector<std::size_t>> sequential(sources.size(), std::vector<std::size_t>(n));
+    for(std::size_t i = 0; i < sources.size(); i++) {
+        gr::dijkstra_h(graph, index.nodes[sources[i]]);
+        for(std::size_t v = 0; v < n; v++) sequential[i][v] = index.nodes[v]->node_data.len;
+    }
+    auto sequential_time = std::chrono::steady_clock::now() - clock_start;
+
+    clock_start = std::chrono::steady_clock::now();
+    gr::csr::BatchDijkstra<std::size_t> batch{ g };
+    auto batched = batch.distances(sources);
+    auto batch_time = std::chrono::steady_clock::now() - clock_start;
+
+    assert(batched == sequential && "batch differs from the dijkstra_h loop");
+    using ms = std::chrono::duration<double, std::milli>;
+    std::println("{} sources: dijkstra_h loop {:.1f}ms, batch on {} threads {:.1f}ms",
+            sources.size(), ms(sequential_time).count(), batch.thread_count(), ms(batch_time).count());
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_astar_and_alt();
+        test_alt_on_graph();
+        test_bidirectional_engine();
+        test_engine_matches_dijkstra();
+        test_engine_matches_dijkstra_h();
+        test_monotone_queue_engines();
+        test_dial_engine_sized_from_graph();
+        test_delta_stepping();
+        test_delta_stepping_heavy_arcs();
+        test_delta_stepping_matches_dijkstra_h();
+        test_batch_dijkstra();
+        test_bellman_ford();
+        test_johnson();
+    }
+    bench_batch_dijkstra();
+}
@@ -0,0 +1,999 @@
+#ifndef GRAPH_SSSP_HPP
+#define GRAPH_SSSP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cmath>
+#include <cstddef>
+#include <datatypes.hpp>
+#include <exception>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    namespace {
+        template <typename Queue>
+        struct is_dial_queue : std::false_type {};
+        template <typename Key>
+        struct is_dial_queue<dt::DialQueue<Key>> : std::true_type {};
+
+        /// a queue ready for shortest paths over g, Dial's buckets are sized
+        /// for the heaviest arc and every other queue is default constructed
+        template <typename Queue, typename W>
+        inline Queue queue_for(const CSRGraph<W>& g) {
+            if constexpr (is_dial_queue<Queue>::value) {
+                W max_weight = 0;
+                for(auto w : g.weights()) max_weight = std::max(max_weight, w);
+                return Queue(max_weight);
+            } else {
+                return Queue{};
+            }
+        }
+    }
+
+    /// single source shortest paths over a CSRGraph with all of its state
+    /// (distances, predecessors, queue) owned by the engine and reused between
+    /// runs. Only vertices that get reached enter the queue and they are
+    /// relaxed with decrease-key, so a run is O((V+E) log V) and a new run
+    /// does not pay for clearing the arrays. Node data is never touched.
+    /// Queue can be swapped for a monotone integer queue (dt::DialQueue,
+    /// dt::RadixHeap) that leaves stale copies behind instead of decreasing keys
+    template <typename W, typename Queue = dt::IndexedHeap<W>>
+    class DijkstraEngine {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+        inline static constexpr std::size_t NO_SLOT = std::numeric_limits<std::size_t>::max();
+    private:
+        const CSRGraph<W>* m_graph;
+        std::vector<W> m_len{};
+        std::vector<vertex_t> m_prev{};
+        std::vector<std::size_t> m_prev_slot{};
+        /// vertices with a valid m_len in the current run
+        dt::EpochSet m_reached{};
+        dt::EpochSet m_settled{};
+        /// targets of a multi target run
+        dt::EpochSet m_targets{};
+        Queue m_heap{};
+        vertex_t m_source{NIL};
+        std::size_t m_settled_n{};
+
+        inline void start(vertex_t source) {
+            auto const n = m_graph->vertex_count();
+            if(m_len.size() < n) {
+                m_len.resize(n);
+                m_prev.resize(n);
+                m_prev_slot.resize(n);
+                m_reached.resize(n);
+                m_settled.resize(n);
+                m_heap.resize(n);
+            }
+            m_reached.clear();
+            m_settled.clear();
+            m_heap.clear();
+            m_source = source;
+            m_settled_n = 0;
+            m_reached.insert(source);
+            m_len[source] = 0;
+            m_prev[source] = NIL;
+            m_prev_slot[source] = NO_SLOT;
+            m_heap.push(source, 0);
+        }
+        /// settles the closest queued vertex and relaxes its out-arcs,
+        /// NIL if the extracted entry was a stale copy
+        inline vertex_t settle_next() {
+            auto& g = *m_graph;
+            auto [k, idx] = m_heap.extract();
+            auto w = static_cast<vertex_t>(idx);
+            if(!m_settled.try_insert(w)) return NIL;
+            m_settled_n++;
+            for(auto slot = g.edge_begin(w); slot < g.edge_end(w); slot++) {
+                auto h = g.head(slot);
+                if(m_settled.contains(h)) continue;
+                auto candidate = k + g.weight(slot);
+                if(m_reached.try_insert(h) || candidate < m_len[h]) {
+                    m_len[h] = candidate;
+                    m_prev[h] = w;
+                    m_prev_slot[h] = slot;
+                    m_heap.push_or_decrease(h, candidate);
+                }
+            }
+            return w;
+        }
+    public:
+        /// the queue comes from queue_for, so a DialQueue fits the heaviest arc of g
+        explicit DijkstraEngine(const CSRGraph<W>& g) : DijkstraEngine(g, queue_for<Queue>(g)) {}
+        DijkstraEngine(const CSRGraph<W>& g, Queue queue) : m_graph(&g), m_heap(std::move(queue)) {}
+
+        /// distances from source to every vertex
+        inline void run(vertex_t source) {
+            start(source);
+            while(!m_heap.empty()) {
+                settle_next();
+            }
+        }
+        /// stops as soon as target is settled, true if it was reached. Only
+        /// settled vertices are guaranteed to have their final distance then
+        inline bool run(vertex_t source, vertex_t target) {
+            start(source);
+            while(!m_heap.empty()) {
+                if(settle_next() == target) return true;
+            }
+            return false;
+        }
+        /// stops once every target is settled, returns how many were reached
+        inline std::size_t run(vertex_t source, std::span<const vertex_t> targets) {
+            if(m_targets.size() < m_graph->vertex_count()) {
+                m_targets.resize(m_graph->vertex_count());
+            }
+            m_targets.clear();
+            std::size_t pending = 0;
+            for(auto t : targets) {
+                if(m_targets.try_insert(t)) pending++;
+            }
+            std::size_t total = pending;
+            start(source);
+            while(pending && !m_heap.empty()) {
+                auto w = settle_next();
+                if(w != NIL && m_targets.contains(w)) pending--;
+            }
+            return total - pending;
+        }
+
+        inline const CSRGraph<W>& graph() const {
+            return *m_graph;
+        }
+        inline vertex_t source() const {
+            return m_source;
+        }
+        /// vertices settled by the last run
+        inline std::size_t settled_count() const {
+            return m_settled_n;
+        }
+        inline bool settled(vertex_t v) const {
+            return m_settled.contains(v);
+        }
+        /// INF when v was not reached by the last run
+        inline W distance(vertex_t v) const {
+            return m_reached.contains(v) ? m_len[v] : INF;
+        }
+        inline vertex_t predecessor(vertex_t v) const {
+            return m_reached.contains(v) ? m_prev[v] : NIL;
+        }
+        /// slot of the arc v was reached through, NO_SLOT for the source
+        inline std::size_t predecessor_slot(vertex_t v) const {
+            return m_reached.contains(v) ? m_prev_slot[v] : NO_SLOT;
+        }
+        /// distance of every vertex, INF when unreachable
+        inline std::vector<W> distances() const {
+            std::vector<W> len(m_graph->vertex_count(), INF);
+            for(vertex_t v = 0; v < len.size(); v++) {
+                if(m_reached.contains(v)) len[v] = m_len[v];
+            }
+            return len;
+        }
+        /// vertices from the source to target, empty when target was not reached
+        inline std::vector<vertex_t> path(vertex_t target) const {
+            std::vector<vertex_t> p{};
+            if(!m_reached.contains(target)) return p;
+            for(auto v = target; v != NIL; v = m_prev[v]) {
+                p.push_back(v);
+            }
+            std::reverse(p.begin(), p.end());
+            return p;
+        }
+        /// arc slots from the source to target, use edge_ref to get the original edges
+        inline std::vector<std::size_t> path_slots(vertex_t target) const {
+            std::vector<std::size_t> p{};
+            if(!m_reached.contains(target)) return p;
+            for(auto v = target; m_prev[v] != NIL; v = m_prev[v]) {
+                p.push_back(m_prev_slot[v]);
+            }
+            std::reverse(p.begin(), p.end());
+            return p;
+        }
+    };
+
+    template <typename W>
+    using DialDijkstraEngine = DijkstraEngine<W, dt::DialQueue<W>>;
+    template <typename W>
+    using RadixDijkstraEngine = DijkstraEngine<W, dt::RadixHeap<W>>;
+    /// radix heap for integral weights, the indexed heap for anything else
+    template <typename W>
+    using MonotoneDijkstraEngine = std::conditional_t<std::is_integral_v<W>,
+          RadixDijkstraEngine<W>, DijkstraEngine<W>>;
+
+    /// engine backed by Dial's buckets sized for the heaviest arc of g,
+    /// meant for graphs with small integer weights
+    template <typename W>
+    inline DialDijkstraEngine<W> make_dial_engine(const CSRGraph<W>& g) {
+        static_assert(std::is_integral_v<W>, "Dial's buckets need integral weights");
+        return DialDijkstraEngine<W>(g);
+    }
+
+    /// point to point shortest paths searching forward from the source over g
+    /// and backward from the target over rev = g.transpose() at the same time.
+    /// mu is the best source-target distance seen where the two searches
+    /// touched, the run stops once the two queue minima add up to at least mu.
+    /// State is reused between runs like in DijkstraEngine
+    template <typename W>
+    class BidirectionalDijkstraEngine {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+    private:
+        struct Side {
+            const CSRGraph<W>* graph;
+            std::vector<W> len{};
+            std::vector<vertex_t> prev{};
+            std::vector<std::size_t> prev_slot{};
+            dt::EpochSet reached{};
+            dt::EpochSet settled{};
+            dt::IndexedHeap<W> heap{};
+
+            inline void start(vertex_t from) {
+                auto const n = graph->vertex_count();
+                if(len.size() < n) {
+                    len.resize(n);
+                    prev.resize(n);
+                    prev_slot.resize(n);
+                    reached.resize(n);
+                    settled.resize(n);
+                    heap.resize(n);
+                }
+                reached.clear();
+                settled.clear();
+                heap.clear();
+                reached.insert(from);
+                len[from] = 0;
+                prev[from] = NIL;
+                heap.push(from, 0);
+            }
+            inline W distance(vertex_t v) const {
+                return reached.contains(v) ? len[v] : INF;
+            }
+        };
+        Side m_fwd;
+        Side m_bwd;
+        vertex_t m_source{NIL};
+        vertex_t m_target{NIL};
+        vertex_t m_meet{NIL};
+        W m_mu{INF};
+        std::size_t m_settled_n{};
+
+        /// settles one vertex of side and checks its arcs against the other side
+        inline void step(Side& side, const Side& other) {
+            auto [k, idx] = side.heap.extract();
+            auto v = static_cast<vertex_t>(idx);
+            side.settled.insert(v);
+            m_settled_n++;
+            auto& g = *side.graph;
+            for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                auto h = g.head(slot);
+                if(side.settled.contains(h)) continue;
+                auto candidate = k + g.weight(slot);
+                if(side.reached.try_insert(h) || candidate < side.len[h]) {
+                    side.len[h] = candidate;
+                    side.prev[h] = v;
+                    side.prev_slot[h] = slot;
+                    side.heap.push_or_decrease(h, candidate);
+                }
+                if(auto rest = other.distance(h); rest != INF && side.len[h] + rest < m_mu) {
+                    m_mu = side.len[h] + rest;
+                    m_meet = h;
+                }
+            }
+        }
+    public:
+        BidirectionalDijkstraEngine(const CSRGraph<W>& g, const CSRGraph<W>& rev) : m_fwd{ &g }, m_bwd{ &rev } {}
+
+        /// distance from source to target, INF when there is no path
+        inline W run(vertex_t source, vertex_t target) {
+            m_source = source;
+            m_target = target;
+            m_fwd.start(source);
+            m_bwd.start(target);
+            m_settled_n = 0;
+            m_mu = source == target ? 0 : INF;
+            m_meet = source == target ? source : NIL;
+
+            while(!m_fwd.heap.empty() && !m_bwd.heap.empty()) {
+                auto f_min = std::get<0>(m_fwd.heap.top());
+                auto b_min = std::get<0>(m_bwd.heap.top());
+                if(m_mu != INF && f_min + b_min >= m_mu) break;
+                // grow the side with the smaller queue
+                if(m_fwd.heap.size() <= m_bwd.heap.size()) {
+                    step(m_fwd, m_bwd);
+                } else {
+                    step(m_bwd, m_fwd);
+                }
+            }
+            return m_mu;
+        }
+        inline W distance() const {
+            return m_mu;
+        }
+        /// vertices settled by both searches in the last run
+        inline std::size_t settled_count() const {
+            return m_settled_n;
+        }
+        /// vertices from the source to the target, empty when there is no path
+        inline std::vector<vertex_t> path() const {
+            std::vector<vertex_t> p{};
+            if(m_meet == NIL) return p;
+            for(auto v = m_meet; v != NIL; v = m_fwd.prev[v]) {
+                p.push_back(v);
+            }
+            std::reverse(p.begin(), p.end());
+            for(auto v = m_bwd.prev[m_meet]; v != NIL; v = m_bwd.prev[v]) {
+                p.push_back(v);
+            }
+            return p;
+        }
+        /// edge refs (CSRGraph::edge_ref) of the path arcs from the source to the target
+        inline std::vector<std::size_t> path_refs() const {
+            std::vector<std::size_t> p{};
+            if(m_meet == NIL) return p;
+            for(auto v = m_meet; m_fwd.prev[v] != NIL; v = m_fwd.prev[v]) {
+                p.push_back(m_fwd.graph->edge_ref(m_fwd.prev_slot[v]));
+            }
+            std::reverse(p.begin(), p.end());
+            for(auto v = m_meet; m_bwd.prev[v] != NIL; v = m_bwd.prev[v]) {
+                p.push_back(m_bwd.graph->edge_ref(m_bwd.prev_slot[v]));
+            }
+            return p;
+        }
+    };
+
+    /// goal directed point to point search, the queue key of a vertex is its
+    /// distance plus heuristic(v), a lower bound on the distance from v to the
+    /// target. A vertex is expanded again if its distance improves afterwards,
+    /// so admissible heuristics that are not consistent still work
+    template <typename W>
+    class AStarEngine {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+        inline static constexpr vertex_t NIL = CSRGraph<W>::NIL;
+    private:
+        const CSRGraph<W>* m_graph;
+        std::vector<W> m_len{};
+        std::vector<vertex_t> m_prev{};
+        std::vector<std::size_t> m_prev_slot{};
+        dt::EpochSet m_reached{};
+        dt::IndexedHeap<W> m_heap{};
+        vertex_t m_target{NIL};
+        std::size_t m_expanded{};
+    public:
+        explicit AStarEngine(const CSRGraph<W>& g) : m_graph(&g) {}
+
+        /// distance from source to target, INF when there is no path
+        template <typename H>
+        inline W run(vertex_t source, vertex_t target, H&& heuristic) {
+            auto& g = *m_graph;
+            auto const n = g.vertex_count();
+            if(m_len.size() < n) {
+                m_len.resize(n);
+                m_prev.resize(n);
+                m_prev_slot.resize(n);
+                m_reached.resize(n);
+                m_heap.resize(n);
+            }
+            m_reached.clear();
+            m_heap.clear();
+            m_target = target;
+            m_expanded = 0;
+
+            m_reached.insert(source);
+            m_len[source] = 0;
+            m_prev[source] = NIL;
+            m_heap.push(source, heuristic(source));
+            while(!m_heap.empty()) {
+                auto v = static_cast<vertex_t>(std::get<1>(m_heap.extract()));
+                if(v == target) return m_len[v];
+                m_expanded++;
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    auto h = g.head(slot);
+                    auto candidate = m_len[v] + g.weight(slot);
+                    if(!m_reached.contains(h) || candidate < m_len[h]) {
+                        // INF means the target cannot be reached from h at all
+                        auto estimate = heuristic(h);
+                        if(estimate == INF) continue;
+                        m_reached.insert(h);
+                        m_len[h] = candidate;
+                        m_prev[h] = v;
+                        m_prev_slot[h] = slot;
+                        m_heap.push_or_decrease(h, candidate + estimate);
+                    }
+                }
+            }
+            return INF;
+        }
+        /// vertices expanded by the last run
+        inline std::size_t settled_count() const {
+            return m_expanded;
+        }
+        /// vertices from the source to the target, empty when there is no path
+        inline std::vector<vertex_t> path() const {
+            std::vector<vertex_t> p{};
+            if(m_target == NIL || !m_reached.contains(m_target)) return p;
+            for(auto v = m_target; v != NIL; v = m_prev[v]) {
+                p.push_back(v);
+            }
+            std::reverse(p.begin(), p.end());
+            return p;
+        }
+        /// arc slots from the source to the target
+        inline std::vector<std::size_t> path_slots() const {
+            std::vector<std::size_t> p{};
+            if(m_target == NIL || !m_reached.contains(m_target)) return p;
+            for(auto v = m_target; m_prev[v] != NIL; v = m_prev[v]) {
+                p.push_back(m_prev_slot[v]);
+            }
+            std::reverse(p.begin(), p.end());
+            return p;
+        }
+    };
+
+    /// ALT (A*, landmarks, triangle inequality) preprocessing. For every
+    /// landmark L the distances L -> v and v -> L are stored, and then
+    ///     d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+    /// give an admissible and consistent lower bound for A*
+    template <typename W>
+    class AltLandmarks {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+    private:
+        std::vector<vertex_t> m_landmarks{};
+        /// m_from[l * n + v] = d(L, v), m_to[l * n + v] = d(v, L)
+        std::vector<W> m_from{};
+        std::vector<W> m_to{};
+        std::size_t m_n{};
+
+        inline void add(DijkstraEngine<W>& fwd, DijkstraEngine<W>& bwd, vertex_t landmark) {
+            m_landmarks.push_back(landmark);
+            fwd.run(landmark);
+            bwd.run(landmark);
+            for(vertex_t v = 0; v < m_n; v++) {
+                m_from.push_back(fwd.distance(v));
+            }
+            for(vertex_t v = 0; v < m_n; v++) {
+                m_to.push_back(bwd.distance(v));
+            }
+        }
+        /// a - b clamped at 0, 0 when either side is unknown
+        inline static W gap(W a, W b) {
+            if(a == INF || b == INF || !(b < a)) return 0;
+            return a - b;
+        }
+    public:
+        /// uses the given landmarks, rev must be g.transpose()
+        AltLandmarks(const CSRGraph<W>& g, const CSRGraph<W>& rev, const std::vector<vertex_t>& landmarks)
+            : m_n(g.vertex_count()) {
+            DijkstraEngine<W> fwd{ g };
+            DijkstraEngine<W> bwd{ rev };
+            for(auto l : landmarks) add(fwd, bwd, l);
+        }
+        /// picks count landmarks by farthest point selection starting from first,
+        /// every next landmark is the vertex farthest from the ones chosen so far
+        /// (vertices none of them reach count as farthest)
+        AltLandmarks(const CSRGraph<W>& g, const CSRGraph<W>& rev, std::size_t count, vertex_t first = 0)
+            : m_n(g.vertex_count()) {
+            if(m_n == 0) return;
+            DijkstraEngine<W> fwd{ g };
+            DijkstraEngine<W> bwd{ rev };
+            std::vector<W> closest(m_n, INF);
+            auto next = first;
+            for(std::size_t i = 0; i < count; i++) {
+                add(fwd, bwd, next);
+                auto row = m_from.data() + (m_landmarks.size() - 1) * m_n;
+                // landmarks are at distance 0 from themselves, unreached vertices at INF
+                for(vertex_t v = 0; v < m_n; v++) {
+                    closest[v] = std::min(closest[v], row[v]);
+                }
+                next = static_cast<vertex_t>(std::max_element(closest.begin(), closest.end()) - closest.begin());
+                if(closest[next] == 0) break;
+            }
+        }
+
+        inline const std::vector<vertex_t>& landmarks() const {
+            return m_landmarks;
+        }
+        /// lower bound on d(v, target)
+        inline W bound(vertex_t v, vertex_t target) const {
+            W best = 0;
+            for(std::size_t l = 0; l < m_landmarks.size(); l++) {
+                auto* from = m_from.data() + l * m_n;
+                auto* to = m_to.data() + l * m_n;
+                // a path v -> target would extend L -> v to L -> target and target -> L to v -> L
+                if(from[v] != INF && from[target] == INF) return INF;
+                if(to[target] != INF && to[v] == INF) return INF;
+                best = std::max({ best, gap(from[target], from[v]), gap(to[v], to[target]) });
+            }
+            return best;
+        }
+        /// heuristic for AStarEngine::run towards target
+        inline auto heuristic(vertex_t target) const {
+            return [this, target](vertex_t v) { return bound(v, target); };
+        }
+    };
+
+    /// ALT bound usable with gr::astar_shortest_path, alt must be built over
+    /// CSRGraph::from_graph(index) so vertex ids match the index
+    template <typename W, typename T, typename E>
+    inline auto alt_heuristic(const AltLandmarks<W>& alt, const GraphIndex<T, E>& index,
+            const typename Graph<T, E>::node_t* target) {
+        auto t = static_cast<typename AltLandmarks<W>::vertex_t>(index.id(target));
+        return [&alt, &index, t](const typename Graph<T, E>::node_t* v) {
+            auto bound = alt.bound(static_cast<typename AltLandmarks<W>::vertex_t>(index.id(v)), t);
+            return bound == AltLandmarks<W>::INF ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(bound);
+        };
+    }
+
+    struct DeltaSteppingOptions {
+        /// bucket width, arcs no heavier than delta are light. 0 picks the
+        /// heaviest arc weight over the average out degree. Values are kept
+        /// within [heaviest arc / 65536, heaviest arc] (at least 1 for integral
+        /// weights) so the cyclic bucket array stays small
+        double delta = 0;
+        /// 0 uses std::thread::hardware_concurrency
+        std::size_t threads = 0;
+    };
+
+    namespace {
+        /// lowers target to value, true if this call lowered it
+        template <typename W>
+        inline bool atomic_min(std::atomic<W>& target, W value) {
+            auto current = target.load(std::memory_order_relaxed);
+            while(value < current) {
+                if(target.compare_exchange_weak(current, value, std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+    }
+
+    /// delta-stepping single source shortest paths. Tentative distances are
+    /// kept in buckets of width delta, the lowest bucket is emptied by
+    /// relaxing its light arcs over and over (vertices can fall back into it),
+    /// then the heavy arcs of everything it held are relaxed once. Live
+    /// distances never reach further than the heaviest arc past the current
+    /// bucket, so the buckets form a cyclic array indexed by bucket % size. Every phase
+    /// splits its frontier between the workers in blocks, distances are
+    /// lowered with an atomic min and improved vertices are collected per
+    /// worker, the buckets are updated at the phase barrier like in bfs_parallel.
+    /// Weights must be non-negative, the result equals csr::dijkstra
+    template <typename W>
+    inline std::vector<W> delta_stepping(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start,
+            DeltaSteppingOptions opt = {}) {
+        static_assert(std::is_arithmetic_v<W>, "delta-stepping needs arithmetic weights");
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr W INF = CSRGraph<W>::INF;
+        constexpr std::size_t BLOCK = 64;
+        auto const n = g.vertex_count();
+        auto const threads = worker_count(opt.threads);
+
+        constexpr double MAX_BUCKETS = 1 << 16;
+        W max_weight = 0;
+        for(auto w : g.weights()) max_weight = std::max(max_weight, w);
+        auto const heaviest = static_cast<double>(max_weight);
+        double delta = opt.delta;
+        if(!(delta > 0)) {
+            auto avg_degree = n ? static_cast<double>(g.edge_count()) / static_cast<double>(n) : 0.0;
+            delta = heaviest / std::max(1.0, avg_degree);
+        }
+        // wider than the heaviest arc changes nothing, much narrower only adds empty buckets
+        delta = std::clamp(delta, heaviest / MAX_BUCKETS, std::max(heaviest, 0.0));
+        if constexpr (std::is_integral_v<W>) {
+            delta = std::max(1.0, std::floor(delta));
+        } else if(!(delta > 0)) {
+            delta = 1;
+        }
+        auto const light = static_cast<W>(delta);
+        auto bucket_of = [delta](W d) { return static_cast<std::size_t>(static_cast<double>(d) / delta); };
+        // one bucket for the current one, the ones a heaviest arc can reach and one for rounding
+        auto const bucket_count = static_cast<std::size_t>(std::ceil(heaviest / delta)) + 2;
+
+        std::vector<std::atomic<W>> len(n);
+        for(auto& l : len) l.store(INF, std::memory_order_relaxed);
+        len[start].store(0, std::memory_order_relaxed);
+
+        std::vector<std::vector<vertex_t>> buckets(bucket_count);
+        buckets[0].push_back(start);
+        std::size_t current = 0;
+        // vertices taken from the current bucket, their heavy arcs wait for the bucket to empty
+        std::vector<vertex_t> removed{};
+        dt::EpochSet in_frontier(n), in_removed(n);
+        std::vector<vertex_t> frontier{};
+        std::vector<std::vector<vertex_t>> improved(threads);
+        std::atomic<std::size_t> cursor{0};
+        bool heavy_phase = false;
+        bool done = false;
+
+        // moves the live entries of the current bucket into the frontier
+        auto take_bucket = [&]() {
+            frontier.clear();
+            in_frontier.clear();
+            auto& bucket = buckets[current % bucket_count];
+            for(auto v : bucket) {
+                if(bucket_of(len[v].load(std::memory_order_relaxed)) != current) continue;
+                if(!in_frontier.try_insert(v)) continue;
+                frontier.push_back(v);
+                if(in_removed.try_insert(v)) removed.push_back(v);
+            }
+            bucket.clear();
+        };
+        // runs on one thread once everyone reached the barrier
+        auto next_phase = [&]() noexcept {
+            for(auto& buffer : improved) {
+                for(auto v : buffer) {
+                    buckets[bucket_of(len[v].load(std::memory_order_relaxed)) % bucket_count].push_back(v);
+                }
+                buffer.clear();
+            }
+            cursor.store(0, std::memory_order_relaxed);
+            if(!heavy_phase) {
+                take_bucket();
+                if(!frontier.empty()) return;
+                heavy_phase = true;
+                frontier.swap(removed);
+                return;
+            }
+            heavy_phase = false;
+            removed.clear();
+            in_removed.clear();
+            // every live vertex is within bucket_count buckets of the current one
+            for(std::size_t step = 0; step < bucket_count; step++, current++) {
+                take_bucket();
+                if(!frontier.empty()) return;
+            }
+            done = true;
+        };
+        take_bucket();
+        std::barrier sync(static_cast<std::ptrdiff_t>(threads), next_phase);
+
+        auto worker = [&](std::size_t t) {
+            auto& out = improved[t];
+            while(!done) {
+                for(;;) {
+                    auto begin = cursor.fetch_add(BLOCK, std::memory_order_relaxed);
+                    if(begin >= frontier.size()) break;
+                    auto end = std::min(begin + BLOCK, frontier.size());
+                    for(auto i = begin; i < end; i++) {
+                        auto v = frontier[i];
+                        auto d = len[v].load(std::memory_order_relaxed);
+                        for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                            auto w = g.weight(slot);
+                            if((w <= light) == heavy_phase) continue;
+                            if(atomic_min(len[g.head(slot)], static_cast<W>(d + w))) {
+                                out.push_back(g.head(slot));
+                            }
+                        }
+                    }
+                }
+                sync.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::thread> workers{};
+        for(std::size_t t = 1; t < threads; t++) {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for(auto& w : workers) w.join();
+
+        std::vector<W> result(n);
+        for(std::size_t v = 0; v < n; v++) {
+            result[v] = len[v].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /// shortest path tree of one source, parent is NIL for the source and
+    /// for unreached vertices, whose len is INF
+    template <typename W>
+    struct ShortestPathTree {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr std::size_t NO_SLOT = DijkstraEngine<W>::NO_SLOT;
+
+        vertex_t source{};
+        std::vector<W> len{};
+        std::vector<vertex_t> parent{};
+        /// slot of the arc each vertex was reached through, NO_SLOT if none
+        std::vector<std::size_t> parent_slot{};
+    };
+
+    /// many shortest path queries on one graph at once. Sources are handed
+    /// out to the workers one at a time, each worker owns a DijkstraEngine that
+    /// it reuses for all of its sources and across batches, the graph is only
+    /// read. threads == 0 uses std::thread::hardware_concurrency
+    template <typename W, typename Queue = dt::IndexedHeap<W>>
+    class BatchDijkstra {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        using engine_t = DijkstraEngine<W, Queue>;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+    private:
+        const CSRGraph<W>* m_graph;
+        std::vector<engine_t> m_engines{};
+
+        /// calls job(engine, i) for every i < count spread over the workers
+        template <typename F>
+        inline void for_each(std::size_t count, F&& job) {
+            auto const threads = std::min(m_engines.size(), count);
+            if(threads <= 1) {
+                for(std::size_t i = 0; i < count; i++) job(m_engines[0], i);
+                return;
+            }
+            std::atomic<std::size_t> cursor{0};
+            std::vector<std::exception_ptr> errors(threads);
+            auto worker = [&](std::size_t t) {
+                try {
+                    for(auto i = cursor.fetch_add(1); i < count; i = cursor.fetch_add(1)) {
+                        job(m_engines[t], i);
+                    }
+                } catch(...) {
+                    errors[t] = std::current_exception();
+                    cursor.store(count);
+                }
+            };
+            std::vector<std::thread> workers{};
+            for(std::size_t t = 1; t < threads; t++) {
+                workers.emplace_back(worker, t);
+            }
+            worker(0);
+            for(auto& w : workers) w.join();
+            for(auto& e : errors) {
+                if(e) std::rethrow_exception(e);
+            }
+        }
+    public:
+        /// every engine gets a queue_for(g), sized for g when it is a DialQueue
+        explicit BatchDijkstra(const CSRGraph<W>& g, std::size_t threads = 0)
+            : BatchDijkstra(g, threads, queue_for<Queue>(g)) {}
+        BatchDijkstra(const CSRGraph<W>& g, std::size_t threads, Queue queue) : m_graph(&g) {
+            threads = worker_count(threads);
+            m_engines.reserve(threads);
+            for(std::size_t t = 0; t < threads; t++) {
+                m_engines.emplace_back(g, queue);
+            }
+        }
+
+        inline std::size_t thread_count() const {
+            return m_engines.size();
+        }
+        /// row i holds the distances from sources[i] to every vertex, or to
+        /// targets[j] in column j when targets are given, in which case each
+        /// search stops once all of the targets are settled
+        inline std::vector<std::vector<W>> distances(std::span<const vertex_t> sources,
+                std::span<const vertex_t> targets = {}) {
+            std::vector<std::vector<W>> matrix(sources.size());
+            for_each(sources.size(), [&](engine_t& engine, std::size_t i) {
+                if(targets.empty()) {
+                    engine.run(sources[i]);
+                    matrix[i] = engine.distances();
+                    return;
+                }
+                engine.run(sources[i], targets);
+                auto& row = matrix[i];
+                row.resize(targets.size());
+                for(std::size_t j = 0; j < targets.size(); j++) {
+                    row[j] = engine.settled(targets[j]) ? engine.distance(targets[j]) : INF;
+                }
+            });
+            return matrix;
+        }
+        /// full shortest path tree of every source
+        inline std::vector<ShortestPathTree<W>> trees(std::span<const vertex_t> sources) {
+            auto const n = m_graph->vertex_count();
+            std::vector<ShortestPathTree<W>> result(sources.size());
+            for_each(sources.size(), [&](engine_t& engine, std::size_t i) {
+                engine.run(sources[i]);
+                auto& tree = result[i];
+                tree.source = sources[i];
+                tree.len = engine.distances();
+                tree.parent.resize(n);
+                tree.parent_slot.resize(n);
+                for(vertex_t v = 0; v < n; v++) {
+                    tree.parent[v] = engine.predecessor(v);
+                    tree.parent_slot[v] = engine.predecessor_slot(v);
+                }
+            });
+            return result;
+        }
+    };
+
+    /// result of bellman_ford, parent is NIL for sources and unreached vertices
+    template <typename W>
+    struct BellmanFordResult {
+        using vertex_t = CSRGraph<W>::vertex_t;
+
+        std::vector<W> len{};
+        std::vector<vertex_t> parent{};
+        std::vector<std::size_t> parent_slot{};
+        bool negative_cycle{false};
+        /// vertices of a negative cycle in arc order when one was found
+        std::vector<vertex_t> cycle{};
+    };
+
+    namespace {
+        /// walks parent pointers from v, returns a cycle of the parent graph
+        /// in arc order or nothing when the walk ends at a source
+        template <typename W>
+        inline std::vector<typename CSRGraph<W>::vertex_t> parent_cycle(const BellmanFordResult<W>& r,
+                typename CSRGraph<W>::vertex_t v, dt::EpochSet& seen) {
+            seen.clear();
+            while(v != CSRGraph<W>::NIL && seen.try_insert(v)) {
+                v = r.parent[v];
+            }
+            std::vector<typename CSRGraph<W>::vertex_t> cycle{};
+            if(v == CSRGraph<W>::NIL) return cycle;
+            auto u = v;
+            do {
+                cycle.push_back(u);
+                u = r.parent[u];
+            } while(u != v);
+            std::reverse(cycle.begin(), cycle.end());
+            return cycle;
+        }
+
+        /// queue based Bellman-Ford (SPFA) from every vertex already in queue.
+        /// A vertex is queued at most once at a time and only after its
+        /// distance dropped, so the run ends as soon as nothing changes. Any
+        /// cycle in the parent graph is negative, it is looked for whenever
+        /// a path reaches another multiple of n arcs
+        template <typename W>
+        inline void spfa(const CSRGraph<W>& g, BellmanFordResult<W>& r, std::vector<typename CSRGraph<W>::vertex_t>& queue) {
+            auto const n = g.vertex_count();
+            std::vector<std::size_t> arcs_n(n, 0);
+            std::vector<bool> queued(n, false);
+            dt::EpochSet seen(n);
+            for(auto v : queue) queued[v] = true;
+
+            // the queue is a ring over a vector of n slots
+            std::size_t head = 0, size = queue.size();
+            queue.resize(std::max<std::size_t>(n, 1));
+            while(size) {
+                auto u = queue[head];
+                head = head + 1 == queue.size() ? 0 : head + 1;
+                size--;
+                queued[u] = false;
+                // only vertices with a finite distance are ever queued
+                auto const du = r.len[u];
+                for(auto slot = g.edge_begin(u); slot < g.edge_end(u); slot++) {
+                    auto v = g.head(slot);
+                    auto candidate = du + g.weight(slot);
+                    if(!(candidate < r.len[v])) continue;
+                    r.len[v] = candidate;
+                    r.parent[v] = u;
+                    r.parent_slot[v] = slot;
+                    arcs_n[v] = arcs_n[u] + 1;
+                    if(arcs_n[v] % n == 0) {
+                        r.cycle = parent_cycle(r, v, seen);
+                        if(!r.cycle.empty()) {
+                            r.negative_cycle = true;
+                            return;
+                        }
+                    }
+                    if(!queued[v]) {
+                        queued[v] = true;
+                        queue[(head + size) % queue.size()] = v;
+                        size++;
+                    }
+                }
+            }
+        }
+        template <typename W>
+        inline BellmanFordResult<W> bellman_ford_init(std::size_t n, W start_len) {
+            BellmanFordResult<W> r{};
+            r.len.assign(n, start_len);
+            r.parent.assign(n, CSRGraph<W>::NIL);
+            r.parent_slot.assign(n, DijkstraEngine<W>::NO_SLOT);
+            return r;
+        }
+    }
+
+    /// single source shortest paths with negative arcs in O(VE) worst case,
+    /// usually far less. Relaxation runs over the contiguous CSR arrays.
+    /// When a negative cycle is reachable from source the distances are
+    /// meaningless and result.cycle holds one of them
+    template <typename W>
+    inline BellmanFordResult<W> bellman_ford(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t source) {
+        auto r = bellman_ford_init<W>(g.vertex_count(), CSRGraph<W>::INF);
+        r.len[source] = 0;
+        std::vector<typename CSRGraph<W>::vertex_t> queue{ source };
+        spfa(g, r, queue);
+        return r;
+    }
+
+    /// Johnson's reweighting: potentials h from a Bellman-Ford run out of a
+    /// virtual source joined to every vertex make w(u, v) + h(u) - h(v)
+    /// non-negative, so every query after that is a DijkstraEngine run on the
+    /// reweighted copy of the graph. Throws when the graph has a negative cycle
+    template <typename W>
+    class Johnson {
+    public:
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr W INF = CSRGraph<W>::INF;
+    private:
+        std::vector<W> m_potential{};
+        /// same slots and edge refs as the input graph
+        CSRGraph<W> m_reweighted{};
+        DijkstraEngine<W> m_engine;
+    public:
+        explicit Johnson(const CSRGraph<W>& g) : m_engine(m_reweighted) {
+            static_assert(std::is_signed_v<W>, "Johnson's reweighting is only needed for signed weights");
+            auto const n = g.vertex_count();
+            // the virtual source starts every vertex at distance 0
+            auto r = bellman_ford_init<W>(n, 0);
+            std::vector<vertex_t> queue(n);
+            for(vertex_t v = 0; v < n; v++) queue[v] = v;
+            spfa(g, r, queue);
+            if(r.negative_cycle) {
+                throw std::runtime_error("the graph has a negative cycle");
+            }
+            m_potential = std::move(r.len);
+
+            std::vector<typename CSRGraph<W>::edge_tuple_t> arcs(g.edge_count());
+            std::vector<std::size_t> refs(g.edge_count());
+            for(vertex_t v = 0; v < n; v++) {
+                for(auto slot = g.edge_begin(v); slot < g.edge_end(v); slot++) {
+                    arcs[slot] = { v, g.head(slot), g.weight(slot) + m_potential[v] - m_potential[g.head(slot)] };
+                    refs[slot] = g.edge_ref(slot);
+                }
+            }
+            m_reweighted = CSRGraph<W>::from_edges(n, arcs, refs);
+        }
+        Johnson(const Johnson&) = delete;
+        Johnson& operator=(const Johnson&) = delete;
+
+        inline const std::vector<W>& potentials() const {
+            return m_potential;
+        }
+        /// non-negative copy of the graph, usable with any of the dijkstra engines
+        inline const CSRGraph<W>& reweighted() const {
+            return m_reweighted;
+        }
+        /// true distance from a reweighted one
+        inline W restore(vertex_t source, vertex_t v, W reweighted_len) const {
+            return reweighted_len == INF ? INF : reweighted_len - m_potential[source] + m_potential[v];
+        }
+        /// distances from source in the original weights, INF when unreachable
+        inline std::vector<W> distances(vertex_t source) {
+            m_engine.run(source);
+            auto len = m_engine.distances();
+            for(vertex_t v = 0; v < len.size(); v++) {
+                len[v] = restore(source, v, len[v]);
+            }
+            return len;
+        }
+        /// shortest path as slots of the input graph, empty when target is unreachable
+        inline std::vector<std::size_t> path_slots(vertex_t source, vertex_t target) {
+            if(!m_engine.run(source, target)) return {};
+            return m_engine.path_slots(target);
+        }
+        /// rows of distances from every source computed by a BatchDijkstra
+        inline std::vector<std::vector<W>> all_pairs(std::span<const vertex_t> sources, std::size_t threads = 0) const {
+            BatchDijkstra<W> batch{ m_reweighted, threads };
+            auto matrix = batch.distances(sources);
+            for(std::size_t i = 0; i < sources.size(); i++) {
+                for(vertex_t v = 0; v < matrix[i].size(); v++) {
+                    matrix[i][v] = restore(sources[i], v, matrix[i][v]);
+                }
+            }
+            return matrix;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include <common.hpp>
+#include <thread>
+#include <graph_csr.hpp>
+#include <graph_traversal.hpp>
+#include <vector>
+
+using csr_t = gr::CSRGraph<>;
+using vertex_t = csr_t::vertex_t;
+
+/// plain queue bfs the optimized variants are checked against
+std::vector<std::size_t> reference_depth(const csr_t& g, vertex_t start) {
+    std::vector<std::size_t> depth(g.vertex_count(), gr::csr::BFSTree<std::size_t>::UNREACHED);
+    std::vector<vertex_t> queue{ start };
+    depth[start] = 0;
+    for(std::size_t i = 0; i < queue.size(); i++) {
+        for(auto w : g.neighbours(queue[i])) {
+            if(depth[w] == gr::csr::BFSTree<std::size_t>::UNREACHED) {
+                depth[w] = depth[queue[i]] + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+    return depth;
+}
+
+void verify_tree(const csr_t& g, vertex_t start, const gr::csr::BFSTree<std::size_t>& tree) {
+    auto depth = reference_depth(g, start);
+    assert(tree.depth == depth && "depth differs from a plain bfs");
+    assert(tree.parent[start] == csr_t::NIL);
+    for(vertex_t v = 0; v < g.vertex_count(); v++) {
+        if(v == start || tree.parent[v] == csr_t::NIL) continue;
+        auto p = tree.parent[v];
+        assert(tree.depth[p] + 1 == tree.depth[v] && "parent is not one level up");
+        auto found = false;
+        for(auto w : g.neighbours(p)) found |= w == v;
+        assert(found && "parent has no arc to the vertex");
+    }
+}
+
+void test_direction_optimizing() {
+    std::size_t n = common::get_random_in_range(1, 300);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 3000));
+    vertex_t start = common::get_random_in_range(0, n - 1);
+    verify_tree(g, start, gr::csr::bfs_direction_optimizing(g, start));
+    // force bottom-up on every level
+    verify_tree(g, start, gr::csr::bfs_direction_optimizing(g, start, { .alpha = g.edge_count() + 1, .beta = n + 1 }));
+    // zero thresholds behave like 1 instead of dividing by zero
+    verify_tree(g, start, gr::csr::bfs_direction_optimizing(g, start, { .alpha = 0, .beta = 0 }));
+}
+
+void test_direction_optimizing_saves_work() {
+    // low diameter graph with a high average degree
+    auto g = common::get_random_graph<csr_t>(2000, 60000);
+    auto tree = gr::csr::bfs_direction_optimizing(g, 0);
+    verify_tree(g, 0, tree);
+    assert(tree.edges_inspected < g.edge_count() && "bottom-up steps did not cut edge inspections");
+}
+
+void test_parallel() {
+    std::size_t n = common::get_random_in_range(1, 500);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 3000));
+    vertex_t start = common::get_random_in_range(0, n - 1);
+    for(std::size_t threads : { 1, 2, 4 }) {
+        auto tree = gr::csr::bfs_parallel(g, start, threads);
+        verify_tree(g, start, tree);
+        assert(gr::csr::reachable(g, start, threads) == gr::csr::dfs(g, start) && "reachable differs from csr::dfs");
+    }
+}
+
+void test_workspace_queries() {
+    std::size_t n = common::get_random_in_range(1, 300);
+    auto g = common::get_random_graph<csr_t>(n, common::get_random_in_range(0, 600));
+    auto rev = g.transpose();
+
+    // every thread runs its own queries against the shared graph
+    std::vector<std::thread> workers{};
+    for(auto t = 0; t < 4; t++) {
+        workers.emplace_back([&]() {
+            gr::csr::TraversalWorkspace ws{};
+            for(vertex_t start = 0; start < n; start++) {
+                gr::csr::dfs(g, start, ws);
+                auto expected = gr::csr::dfs(g, start);
+                for(vertex_t v = 0; v < n; v++) {
+                    assert(ws.explored.contains(v) == expected[v] && "workspace dfs differs from csr::dfs");
+                }
+                gr::csr::bfs(g, start, ws);
+                auto depth = reference_depth(g, start);
+                for(vertex_t v = 0; v < n; v++) {
+                    assert(ws.explored.contains(v) == expected[v] && "workspace bfs differs from csr::dfs");
+                    assert((!expected[v] || ws.label[v] == depth[v]) && "workspace bfs depth is wrong");
+                }
+            }
+            gr::csr::strongly_connected(g, rev, ws);
+            auto scc = gr::csr::strongly_connected(g);
+            for(vertex_t a = 0; a < n; a++) {
+                for(vertex_t b = 0; b < n; b++) {
+                    assert((ws.label[a] == ws.label[b]) == (scc[a] == scc[b]) && "workspace scc grouping differs");
+                }
+            }
+        });
+    }
+    for(auto& w : workers) w.join();
+}
+
+void test_workspace_topo_sort() {
+    // arcs only go from lower to higher ids, so the graph is a dag
+    std::size_t n = common::get_random_in_range(2, 100);
+    std::vector<csr_t::edge_tuple_t> arcs{};
+    for(vertex_t a = 0; a < n; a++) {
+        for(vertex_t b = a + 1; b < n; b++) {
+            if(common::get_random_in_range(1, 100) <= 10) arcs.emplace_back(a, b, 1);
+        }
+    }
+    auto g = csr_t::from_edges(n, arcs);
+    gr::csr::TraversalWorkspace ws{ n };
+    for(auto i = 0; i < 3; i++) {
+        gr::csr::topo_sort(g, ws);
+        for(auto& [a, b, w] : arcs) {
+            assert(ws.label[a] < ws.label[b] && "tail not labeled before head");
+        }
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_direction_optimizing();
+        test_parallel();
+        test_workspace_topo_sort();
+    }
+    for(auto i = 0; i < 10; i++) {
+        test_workspace_queries();
+    }
+    test_direction_optimizing_saves_work();
+}
@@ -0,0 +1,396 @@
+#ifndef GRAPH_TRAVERSAL_HPP
+#define GRAPH_TRAVERSAL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <datatypes.hpp>
+#include <graph_csr.hpp>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gr::csr {
+    template <typename W>
+    struct BFSTree {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        inline static constexpr std::size_t UNREACHED = std::numeric_limits<std::size_t>::max();
+
+        /// number of edges from start, UNREACHED if there is no path
+        std::vector<std::size_t> depth{};
+        /// vertex this one was discovered from, NIL for start and unreached vertices
+        std::vector<vertex_t> parent{};
+        /// how many arcs were looked at, the quantity direction switching saves
+        std::size_t edges_inspected{};
+    };
+    struct DirectionOptimizingOptions {
+        /// go bottom-up once the frontier's out-arcs exceed unexplored arcs / alpha,
+        /// at least 1 (0 is treated as 1)
+        std::size_t alpha = 15;
+        /// go back top-down once the frontier holds fewer than V / beta vertices,
+        /// at least 1 (0 is treated as 1)
+        std::size_t beta = 18;
+    };
+
+    /// Beamer's direction optimizing bfs, rev must be g.transpose(). Small frontiers
+    /// are expanded top-down from a queue, large ones bottom-up by letting every
+    /// unvisited vertex look for a parent in the frontier bitmap
+    template <typename W>
+    inline BFSTree<W> bfs_direction_optimizing(const CSRGraph<W>& g, const CSRGraph<W>& rev,
+            typename CSRGraph<W>::vertex_t start, DirectionOptimizingOptions opt = {}) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr auto UNREACHED = BFSTree<W>::UNREACHED;
+        auto const n = g.vertex_count();
+        opt.alpha = std::max<std::size_t>(1, opt.alpha);
+        opt.beta = std::max<std::size_t>(1, opt.beta);
+
+        BFSTree<W> tree{};
+        tree.depth.assign(n, UNREACHED);
+        tree.parent.assign(n, CSRGraph<W>::NIL);
+        tree.depth[start] = 0;
+
+        std::vector<vertex_t> frontier{ start };
+        std::vector<vertex_t> next{};
+        dt::Bitset front_bits(n);
+        dt::Bitset next_bits(n);
+        bool bottom_up = false;
+        // arcs leaving the frontier and arcs leaving still unvisited vertices
+        std::size_t frontier_arcs = g.degree(start);
+        std::size_t unexplored_arcs = g.edge_count() - frontier_arcs;
+        std::size_t frontier_n = 1;
+
+        for(std::size_t level = 1; frontier_n > 0; level++) {
+            if(!bottom_up && frontier_arcs > unexplored_arcs / opt.alpha) {
+                bottom_up = true;
+                front_bits.clear();
+                for(auto v : frontier) front_bits.set(v);
+            } else if(bottom_up && frontier_n < n / opt.beta) {
+                bottom_up = false;
+                frontier.clear();
+                for(vertex_t v = 0; v < n; v++) {
+                    if(front_bits.test(v)) frontier.push_back(v);
+                }
+            }
+
+            frontier_arcs = 0;
+            frontier_n = 0;
+            if(bottom_up) {
+                next_bits.clear();
+                for(vertex_t w = 0; w < n; w++) {
+                    if(tree.depth[w] != UNREACHED) continue;
+                    for(auto u : rev.neighbours(w)) {
+                        tree.edges_inspected++;
+                        if(front_bits.test(u)) {
+                            tree.parent[w] = u;
+                            tree.depth[w] = level;
+                            next_bits.set(w);
+                            frontier_n++;
+                            frontier_arcs += g.degree(w);
+                            break;
+                        }
+                    }
+                }
+                std::swap(front_bits, next_bits);
+            } else {
+                next.clear();
+                for(auto v : frontier) {
+                    for(auto w : g.neighbours(v)) {
+                        tree.edges_inspected++;
+                        if(tree.depth[w] == UNREACHED) {
+                            tree.parent[w] = v;
+                            tree.depth[w] = level;
+                            next.push_back(w);
+                            frontier_arcs += g.degree(w);
+                        }
+                    }
+                }
+                frontier_n = next.size();
+                std::swap(frontier, next);
+            }
+            unexplored_arcs -= std::min(unexplored_arcs, frontier_arcs);
+        }
+        return tree;
+    }
+    template <typename W>
+    inline BFSTree<W> bfs_direction_optimizing(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start,
+            DirectionOptimizingOptions opt = {}) {
+        return bfs_direction_optimizing(g, g.transpose(), start, opt);
+    }
+
+    namespace {
+        inline std::size_t worker_count(std::size_t threads) {
+            return threads ? threads : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        /// atomically sets bit i, true if this call was the one that set it
+        inline bool claim(std::vector<std::atomic<std::uint64_t>>& bits, std::size_t i) {
+            auto& word = bits[i / 64];
+            auto mask = std::uint64_t{1} << (i % 64);
+            if(word.load(std::memory_order_relaxed) & mask) return false;
+            return !(word.fetch_or(mask, std::memory_order_relaxed) & mask);
+        }
+        /// calls step(v, out) for every vertex of the frontier, spread over the
+        /// workers in blocks when it is big enough, the outputs are concatenated
+        /// into the next frontier
+        template <typename V, typename F>
+        inline std::vector<V> expand_frontier(const std::vector<V>& frontier, std::size_t threads, F&& step) {
+            constexpr std::size_t BLOCK = 256;
+            threads = std::min(threads, (frontier.size() + BLOCK - 1) / BLOCK);
+            std::vector<V> next{};
+            if(threads <= 1) {
+                for(auto v : frontier) step(v, next);
+                return next;
+            }
+            std::vector<std::vector<V>> local(threads);
+            std::atomic<std::size_t> cursor{0};
+            auto worker = [&](std::size_t t) {
+                for(;;) {
+                    auto begin = cursor.fetch_add(BLOCK, std::memory_order_relaxed);
+                    if(begin >= frontier.size()) break;
+                    auto end = std::min(begin + BLOCK, frontier.size());
+                    for(auto i = begin; i < end; i++) step(frontier[i], local[t]);
+                }
+            };
+            std::vector<std::thread> workers{};
+            for(std::size_t t = 1; t < threads; t++) {
+                workers.emplace_back(worker, t);
+            }
+            worker(0);
+            for(auto& w : workers) w.join();
+            for(auto& buffer : local) {
+                next.insert(next.end(), buffer.begin(), buffer.end());
+            }
+            return next;
+        }
+    }
+
+    /// level synchronous bfs, every level's frontier is split between the
+    /// workers in small blocks, each worker claims vertices with an atomic
+    /// fetch_or on the visited bitmap and collects them in its own buffer,
+    /// the buffers become the next frontier at the level barrier.
+    /// threads == 0 uses std::thread::hardware_concurrency
+    template <typename W>
+    inline BFSTree<W> bfs_parallel(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start, std::size_t threads = 0) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        constexpr std::size_t BLOCK = 64;
+        auto const n = g.vertex_count();
+        threads = worker_count(threads);
+
+        BFSTree<W> tree{};
+        tree.depth.assign(n, BFSTree<W>::UNREACHED);
+        tree.parent.assign(n, CSRGraph<W>::NIL);
+        tree.depth[start] = 0;
+
+        std::vector<std::atomic<std::uint64_t>> visited((n + 63) / 64);
+        claim(visited, start);
+        std::vector<vertex_t> frontier{ start };
+        std::vector<std::vector<vertex_t>> local(threads);
+        // every vertex is claimed once, so no level holds more than n and the
+        // merge below never allocates inside the noexcept barrier completion
+        frontier.reserve(n);
+        for(auto& buffer : local) buffer.reserve(n);
+        std::atomic<std::size_t> cursor{0};
+        std::atomic<std::size_t> inspected{0};
+        std::size_t level = 1;
+        bool done = false;
+
+        // runs on one thread once everyone reached the barrier
+        auto merge_level = [&]() noexcept {
+            frontier.clear();
+            for(auto& buffer : local) {
+                frontier.insert(frontier.end(), buffer.begin(), buffer.end());
+                buffer.clear();
+            }
+            cursor.store(0, std::memory_order_relaxed);
+            level++;
+            done = frontier.empty();
+        };
+        std::barrier sync(static_cast<std::ptrdiff_t>(threads), merge_level);
+
+        auto worker = [&](std::size_t t) {
+            auto& next = local[t];
+            std::size_t seen = 0;
+            while(!done) {
+                for(;;) {
+                    auto begin = cursor.fetch_add(BLOCK, std::memory_order_relaxed);
+                    if(begin >= frontier.size()) break;
+                    auto end = std::min(begin + BLOCK, frontier.size());
+                    for(auto i = begin; i < end; i++) {
+                        auto v = frontier[i];
+                        for(auto w : g.neighbours(v)) {
+                            seen++;
+                            if(claim(visited, w)) {
+                                tree.depth[w] = level;
+                                tree.parent[w] = v;
+                                next.push_back(w);
+                            }
+                        }
+                    }
+                }
+                sync.arrive_and_wait();
+            }
+            inspected.fetch_add(seen, std::memory_order_relaxed);
+        };
+
+        std::vector<std::thread> workers{};
+        for(std::size_t t = 1; t < threads; t++) {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for(auto& w : workers) w.join();
+
+        tree.edges_inspected = inspected.load();
+        return tree;
+    }
+    /// which vertices start reaches, computed with bfs_parallel
+    template <typename W>
+    inline std::vector<bool> reachable(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start, std::size_t threads = 0) {
+        auto tree = bfs_parallel(g, start, threads);
+        std::vector<bool> explored(g.vertex_count());
+        for(std::size_t v = 0; v < explored.size(); v++) {
+            explored[v] = tree.depth[v] != BFSTree<W>::UNREACHED;
+        }
+        return explored;
+    }
+
+    /// per query state for traversals over a shared CSRGraph. Nothing is written
+    /// into the graph, so every thread can run queries on the same graph with
+    /// its own workspace, and reset() between queries is O(1)
+    class TraversalWorkspace {
+    public:
+        using vertex_t = CSRGraph<>::vertex_t;
+
+        /// vertices reached by the current query
+        dt::EpochSet explored{};
+        /// per vertex result of the current query (finishing label, scc number),
+        /// only meaningful for explored vertices
+        std::vector<std::size_t> label{};
+
+        /// scratch buffers kept around so queries do not allocate
+        std::vector<std::pair<vertex_t, std::size_t>> stack{};
+        std::vector<vertex_t> queue{};
+        std::vector<vertex_t> order{};
+
+        TraversalWorkspace() {}
+        explicit TraversalWorkspace(std::size_t n) : explored(n), label(n) {}
+
+        /// grows the arrays to fit an n vertex graph, resets the workspace
+        inline void fit(std::size_t n) {
+            if(explored.size() < n) {
+                explored.resize(n);
+                label.resize(n);
+            }
+            reset();
+        }
+        inline void reset() {
+            explored.clear();
+        }
+    };
+
+    namespace {
+        /// iterative dfs from start over vertices not yet explored in ws,
+        /// finished vertices are appended to ws.order when record is set
+        template <typename W>
+        inline void dfs_workspace(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start,
+                TraversalWorkspace& ws, bool record) {
+            auto& stack = ws.stack;
+            stack.clear();
+            ws.explored.insert(start);
+            stack.emplace_back(start, g.edge_begin(start));
+
+            while(!stack.empty()) {
+                auto& [v, slot] = stack.back();
+                if(slot == g.edge_end(v)) {
+                    if(record) ws.order.push_back(v);
+                    stack.pop_back();
+                    continue;
+                }
+                auto w = g.head(slot++);
+                if(ws.explored.try_insert(w)) {
+                    stack.emplace_back(w, g.edge_begin(w));
+                }
+            }
+        }
+    }
+
+    /// marks every vertex reachable from start in ws.explored
+    template <typename W>
+    inline void dfs(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start, TraversalWorkspace& ws) {
+        ws.fit(g.vertex_count());
+        dfs_workspace(g, start, ws, false);
+    }
+    /// marks every vertex reachable from start in ws.explored, ws.label holds its depth
+    template <typename W>
+    inline void bfs(const CSRGraph<W>& g, typename CSRGraph<W>::vertex_t start, TraversalWorkspace& ws) {
+        ws.fit(g.vertex_count());
+        auto& queue = ws.queue;
+        queue.clear();
+        queue.push_back(start);
+        ws.explored.insert(start);
+        ws.label[start] = 0;
+
+        for(std::size_t i = 0; i < queue.size(); i++) {
+            auto v = queue[i];
+            for(auto w : g.neighbours(v)) {
+                if(ws.explored.try_insert(w)) {
+                    ws.label[w] = ws.label[v] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+    /// the labels gr::topo_sort writes into f_value end up in ws.label
+    template <typename W>
+    inline void topo_sort(const CSRGraph<W>& g, TraversalWorkspace& ws) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        ws.fit(g.vertex_count());
+        ws.order.clear();
+        for(vertex_t v = 0; v < g.vertex_count(); v++) {
+            if(!ws.explored.contains(v)) {
+                dfs_workspace(g, v, ws, true);
+            }
+        }
+        // order holds the vertices by finishing time, the last one gets label 0
+        auto label = g.vertex_count();
+        for(auto v : ws.order) {
+            ws.label[v] = --label;
+        }
+    }
+    /// Kosaraju's algorithm with its state in ws, rev must be g.transpose(),
+    /// ws.label holds the scc number of every vertex
+    template <typename W>
+    inline std::size_t strongly_connected(const CSRGraph<W>& g, const CSRGraph<W>& rev, TraversalWorkspace& ws) {
+        using vertex_t = CSRGraph<W>::vertex_t;
+        ws.fit(g.vertex_count());
+        ws.order.clear();
+        for(vertex_t v = 0; v < g.vertex_count(); v++) {
+            if(!ws.explored.contains(v)) {
+                dfs_workspace(rev, v, ws, true);
+            }
+        }
+        ws.reset();
+        std::size_t scc_n = 0;
+        auto& queue = ws.queue;
+        for(auto it = ws.order.rbegin(); it != ws.order.rend(); it++) {
+            if(!ws.explored.try_insert(*it)) continue;
+            queue.clear();
+            queue.push_back(*it);
+            while(!queue.empty()) {
+                auto v = queue.back();
+                queue.pop_back();
+                ws.label[v] = scc_n;
+                for(auto w : g.neighbours(v)) {
+                    if(ws.explored.try_insert(w)) {
+                        queue.push_back(w);
+                    }
+                }
+            }
+            scc_n++;
+        }
+        return scc_n;
+    }
+}
+
+#endif
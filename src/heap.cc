@@ -147,6 +147,66 @@ void heap_sort_min(std::vector<int>& v) {
     std::ranges::for_each(v, trans);
     std::ranges::for_each(v, [&](auto& e){ e = std::get<0>(heap.extract()); });
 }
+void indexed_heap_decrease_and_erase() {
+    auto const size = common::get_random_in_range(1, 200);
+    dt::IndexedHeap<int> heap(size);
+    std::vector<int> keys(size);
+    std::vector<bool> erased(size);
+    for(auto i = 0; i < size; i++) {
+        keys[i] = common::get_random_in_range(-1000, 1000);
+        heap.push(i, keys[i]);
+    }
+    for(auto i = 0; i < size; i++) {
+        auto roll = common::get_random_in_range(1, 100);
+        if(roll <= 30) {
+            keys[i] -= common::get_random_in_range(0, 500);
+            heap.decrease(i, keys[i]);
+        } else if(roll <= 40) {
+            heap.erase(i);
+            erased[i] = true;
+        }
+        // raising a key must not change anything
+        assert((erased[i] || !heap.push_or_decrease(i, keys[i] + 1)) && "push_or_decrease raised a key");
+    }
+    std::vector<int> expected{};
+    for(auto i = 0; i < size; i++) {
+        assert(heap.contains(i) == !erased[i]);
+        if(!erased[i]) expected.push_back(keys[i]);
+    }
+    std::sort(expected.begin(), expected.end());
+    for(auto k : expected) {
+        auto [key, index] = heap.extract();
+        assert(key == k && key == keys[index] && "indexed heap extracted out of order");
+        assert(!heap.contains(index));
+    }
+    assert(heap.empty());
+}
+/// monotone use as in Dijkstra: every pushed key is at least the last extracted one
+template <typename Queue>
+void monotone_queue_order(Queue queue, int max_step) {
+    std::vector<std::size_t> expected_count(200 * max_step + 1);
+    int last = 0;
+    std::size_t pushed = 0;
+    for(auto round = 0; round < 200; round++) {
+        auto n = common::get_random_in_range(0, 5);
+        for(auto i = 0; i < n; i++) {
+            auto key = last + common::get_random_in_range(0, max_step);
+            queue.push(pushed++, key);
+            expected_count[key]++;
+        }
+        if(!queue.empty() && common::get_random_in_range(0, 1)) {
+            auto [key, index] = queue.extract();
+            assert(key >= last && "monotone queue went backwards");
+            assert(expected_count[key]-- > 0 && "monotone queue returned a key that was not pushed");
+            last = key;
+        }
+    }
+    while(!queue.empty()) {
+        auto [key, index] = queue.extract();
+        assert(key >= last && expected_count[key]-- > 0);
+        last = key;
+    }
+}
 int main(void) {
     for (auto i = 0; i < 100; i++){
         std::srand(time(0));
@@ -174,4 +234,11 @@ int main(void) {
     for(auto i = 0; i < 100; i++ )
         heapify_with_search_and_delete();
     test_heap_duplicates();
+    for(auto i = 0; i < 100; i++)
+        indexed_heap_decrease_and_erase();
+    for(auto i = 0; i < 100; i++) {
+        monotone_queue_order(dt::DialQueue<int>(7), 7);
+        monotone_queue_order(dt::RadixHeap<int>(), 7);
+        monotone_queue_order(dt::RadixHeap<int>(), 1000);
+    }
 }
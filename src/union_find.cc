@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cassert>
+#include <common.hpp>
+#include <datatypes.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// random unions checked against a naive labelling that relabels a whole set
+void test_disjoint_sets() {
+    std::size_t n = common::get_random_in_range(1, 500);
+    dt::DisjointSets sets{ n };
+    std::vector<std::size_t> label(n);
+    for(std::size_t i = 0; i < n; i++) label[i] = i;
+    std::size_t count = n;
+
+    for(auto step = 0; step < 1000; step++) {
+        std::size_t x = common::get_random_in_range(0, n - 1);
+        std::size_t y = common::get_random_in_range(0, n - 1);
+        auto merged = label[x] != label[y];
+        if(merged) {
+            auto old = label[y];
+            std::replace(label.begin(), label.end(), old, label[x]);
+            count--;
+        }
+        assert(sets.unite(x, y) == merged && "unite did not report whether it merged");
+        assert(sets.count() == count && "wrong number of sets");
+
+        std::size_t a = common::get_random_in_range(0, n - 1);
+        std::size_t b = common::get_random_in_range(0, n - 1);
+        assert(sets.same_set(a, b) == (label[a] == label[b]));
+        assert(sets.set_size(a) == static_cast<std::size_t>(std::count(label.begin(), label.end(), label[a])));
+    }
+    sets.reset(n);
+    assert(sets.count() == n && sets.set_size(0) == 1);
+}
+
+void test_union_find_elements() {
+    std::vector<std::string> names = { "a", "b", "c", "d", "e" };
+    dt::UnionFind<std::string> union_find{ names };
+    assert(union_find.size() == 5 && union_find.count() == 5);
+    assert(union_find.find("x") == nullptr && !union_find.unionize("a", "x"));
+
+    assert(union_find.unionize("a", "b"));
+    assert(union_find.unionize("c", "d"));
+    assert(!union_find.unionize("b", "a") && "same set merged twice");
+    assert(union_find.unionize("b", "d"));
+    assert(union_find.count() == 2);
+    assert(union_find.same_set("a", "c") && !union_find.same_set("a", "e"));
+    assert(*union_find.find("a") == *union_find.find("d") && "members of one set have different representatives");
+    assert(union_find.set_size("c") == 4 && union_find.set_size("e") == 1 && union_find.set_size("x") == 0);
+    assert(union_find.index("c") == 2);
+}
+
+/// a long chain of unions must not degrade find into a linear walk
+void test_union_find_large() {
+    std::vector<int*> elements(1 << 20);
+    std::vector<int> storage(elements.size());
+    for(std::size_t i = 0; i < elements.size(); i++) elements[i] = &storage[i];
+    dt::UnionFind<int*> union_find{ elements };
+    for(std::size_t i = 1; i < elements.size(); i++) {
+        assert(union_find.unionize(elements[i - 1], elements[i]));
+    }
+    assert(union_find.count() == 1 && union_find.set_size(elements.back()) == elements.size());
+    for(auto* e : elements) {
+        assert(*union_find.find(e) == *union_find.find(elements.front()));
+    }
+}
+
+/// an edge stream split between threads ends in the same partition as sequential unions
+void test_concurrent_disjoint_sets() {
+    std::size_t n = common::get_random_in_range(1, 20000);
+    std::vector<std::pair<std::size_t, std::size_t>> edges(common::get_random_in_range(0, 2 * n));
+    for(auto& [x, y] : edges) {
+        x = common::get_random_in_range(0, n - 1);
+        y = common::get_random_in_range(0, n - 1);
+    }
+    dt::DisjointSets expected{ n };
+    for(auto [x, y] : edges) expected.unite(x, y);
+
+    dt::ConcurrentDisjointSets sets{ n };
+    std::size_t const threads = 4;
+    std::vector<std::size_t> merged(threads, 0);
+    std::vector<std::thread> workers{};
+    for(std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for(auto i = t; i < edges.size(); i += threads) {
+                auto [x, y] = edges[i];
+                merged[t] += sets.unite(x, y) ? 1 : 0;
+                assert(sets.same_set(x, y) && "united handles are in different sets");
+                (void)sets.find(edges[edges.size() - 1 - i].first);
+            }
+        });
+    }
+    for(auto& w : workers) w.join();
+
+    std::size_t total = 0;
+    for(auto m : merged) total += m;
+    assert(total == n - expected.count() && "a merge was counted twice or lost");
+    assert(sets.count() == expected.count());
+    for(std::size_t v = 0; v < n; v++) {
+        std::size_t w = common::get_random_in_range(0, n - 1);
+        assert(sets.same_set(v, w) == expected.same_set(v, w) && "concurrent partition differs");
+    }
+}
+
+int main(void) {
+    for(auto i = 0; i < 100; i++) {
+        test_disjoint_sets();
+    }
+    test_union_find_elements();
+    test_union_find_large();
+    for(auto i = 0; i < 20; i++) {
+        test_concurrent_disjoint_sets();
+    }
+}